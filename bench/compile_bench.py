@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+
+# Copyright 2018-2020 Francesco Biscani
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+# Compile-time scaling benchmark for large named-argument packs.
+#
+# For each pack size, a translation unit is generated which defines that many
+# named arguments and calls a function template with all of them (in a few
+# random orders). The function constructs a parser, fetches every argument and
+# runs the has_*() and has_duplicates() queries. Each translation unit is
+# compiled with every requested compiler, and the wall time, the peak RSS of
+# the compiler and (when -ftime-trace is supported) the number of template
+# instantiations are written to a CSV file.
+
+import argparse
+import csv
+import json
+import os
+import random
+import subprocess
+import sys
+import tempfile
+import time
+
+_DEFAULT_SIZES = [1, 8, 32, 128, 512]
+
+
+def _generate_tu(n, n_orders, seed):
+    rng = random.Random(seed + n)
+
+    lines = ["#include <igor/igor.hpp>", ""]
+    lines += ["IGOR_MAKE_NAMED_ARGUMENT(arg{});".format(i) for i in range(n)]
+
+    all_args = ", ".join("arg{}".format(i) for i in range(n))
+    fetches = " + ".join("p(arg{})".format(i) for i in range(n))
+
+    lines += [
+        "",
+        "template <typename... Args>",
+        "int f(Args &&... args)",
+        "{",
+        "    igor::parser p{args...};",
+        "    static_assert(p.has_all({}));".format(all_args),
+        "    static_assert(p.has_any({}));".format(all_args),
+        "    static_assert(!p.has_other_than({}));".format(all_args),
+        "    static_assert(!p.has_duplicates());",
+        "    return {};".format(fetches),
+        "}",
+        "",
+        "int g()",
+        "{",
+        "    int retval = 0;",
+    ]
+
+    for _ in range(n_orders):
+        order = list(range(n))
+        rng.shuffle(order)
+        lines.append("    retval += f({});".format(", ".join("arg{} = {}".format(i, i) for i in order)))
+
+    lines += ["    return retval;", "}", ""]
+
+    return "\n".join(lines)
+
+
+def _count_instantiations(trace_file):
+    # Extract the total number of class and function template
+    # instantiations from a -ftime-trace JSON file.
+    with open(trace_file) as f:
+        events = json.load(f)["traceEvents"]
+
+    counts = {}
+    for ev in events:
+        name = ev.get("name", "")
+        if name in ("Total InstantiateClass", "Total InstantiateFunction"):
+            counts[name] = ev["args"]["count"]
+
+    return counts.get("Total InstantiateClass", ""), counts.get("Total InstantiateFunction", "")
+
+
+def _supports_time_trace(cxx, tmp_dir):
+    src = os.path.join(tmp_dir, "time_trace_check.cpp")
+    with open(src, "w") as f:
+        f.write("int main() { return 0; }\n")
+
+    ret = subprocess.call([cxx, "-ftime-trace", "-c", src, "-o", os.path.join(tmp_dir, "time_trace_check.o")],
+                          stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+
+    return ret == 0 and os.path.isfile(os.path.join(tmp_dir, "time_trace_check.json"))
+
+
+def _compile(cmd):
+    # Run the compiler, returning the wall time (in seconds) and the peak RSS (in KiB).
+    # NOTE: use wait4() in order to fetch the resource usage of this
+    # specific child process.
+    start = time.perf_counter()
+    proc = subprocess.Popen(cmd)
+    _, status, rusage = os.wait4(proc.pid, 0)
+    elapsed = time.perf_counter() - start
+    # Avoid a spurious warning from the destructor of proc.
+    proc.returncode = os.waitstatus_to_exitcode(status)
+
+    if proc.returncode != 0:
+        raise RuntimeError("compilation failed: {}".format(" ".join(cmd)))
+
+    return elapsed, rusage.ru_maxrss
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compile-time scaling benchmark for igor.")
+    parser.add_argument("--include-dir", required=True, help="path to igor's include directory")
+    parser.add_argument("--compilers", nargs="+", required=True, help="C++ compilers to benchmark")
+    parser.add_argument("--sizes", type=int, nargs="+", default=_DEFAULT_SIZES,
+                        help="numbers of named arguments (default: {})".format(_DEFAULT_SIZES))
+    parser.add_argument("--orders", type=int, default=3, help="number of random call orders per TU")
+    parser.add_argument("--seed", type=int, default=42, help="seed for the random call orders")
+    parser.add_argument("--flags", default="-std=c++17 -O0", help="compiler flags")
+    parser.add_argument("--output", default="compile_bench.csv", help="output CSV file")
+    args = parser.parse_args()
+
+    fields = ["compiler", "n_args", "wall_time_s", "peak_rss_kib", "class_instantiations", "function_instantiations"]
+
+    with tempfile.TemporaryDirectory() as tmp_dir, open(args.output, "w", newline="") as out:
+        writer = csv.DictWriter(out, fieldnames=fields)
+        writer.writeheader()
+
+        for cxx in args.compilers:
+            time_trace = _supports_time_trace(cxx, tmp_dir)
+
+            for n in args.sizes:
+                src = os.path.join(tmp_dir, "bench_{}.cpp".format(n))
+                with open(src, "w") as f:
+                    f.write(_generate_tu(n, args.orders, args.seed))
+
+                obj = os.path.join(tmp_dir, "bench_{}.o".format(n))
+                cmd = [cxx] + args.flags.split() + ["-I", args.include_dir, "-c", src, "-o", obj]
+                if time_trace:
+                    cmd.append("-ftime-trace")
+
+                wall, rss = _compile(cmd)
+
+                n_class, n_func = _count_instantiations(os.path.join(tmp_dir, "bench_{}.json".format(n))) \
+                    if time_trace else ("", "")
+
+                row = {"compiler": cxx, "n_args": n, "wall_time_s": "{:.3f}".format(wall), "peak_rss_kib": rss,
+                       "class_instantiations": n_class, "function_instantiations": n_func}
+                writer.writerow(row)
+                out.flush()
+
+                print(", ".join("{}={}".format(k, row[k]) for k in fields))
+
+    print("Results written to '{}'.".format(args.output))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+
+# Copyright 2018-2020 Francesco Biscani
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+# Measure the per-TU cost of including igor.hpp, and compare it
+# to a reference version of the header (e.g., from an older commit).
+#
+# Usage:
+#
+#   bench/include_cost.py --reference <git revision or path to igor.hpp>
+#
+# For each header, a translation unit which includes it (and nothing else)
+# is compiled repeatedly with -fsyntax-only, and the median wall time is
+# reported together with the number of preprocessed lines.
+
+import argparse
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+_REPO_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def _setup_header(dest_dir, source):
+    # Copy the header into dest_dir/igor/igor.hpp. source can be either
+    # a path to a header file or a git revision.
+    os.makedirs(os.path.join(dest_dir, "igor"))
+    dest = os.path.join(dest_dir, "igor", "igor.hpp")
+
+    if os.path.isfile(source):
+        with open(source, "rb") as f:
+            content = f.read()
+    else:
+        try:
+            content = subprocess.check_output(
+                ["git", "-C", _REPO_ROOT, "show", source + ":include/igor/igor.hpp"])
+        except (OSError, subprocess.CalledProcessError):
+            raise RuntimeError("the reference '{}' is neither a file nor a git revision available "
+                               "in the repository".format(source))
+
+    with open(dest, "wb") as f:
+        f.write(content)
+
+
+def _preprocessed_lines(cxx, std, inc_dir, tu):
+    pp = subprocess.check_output([cxx, "-std=" + std, "-I", inc_dir, "-E", tu])
+
+    return pp.count(b"\n")
+
+
+def _time_syntax_only(cxx, std, inc_dir, tu):
+    start = time.perf_counter()
+    subprocess.check_call([cxx, "-std=" + std, "-I", inc_dir, "-fsyntax-only", tu])
+
+    return time.perf_counter() - start
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Measure the include cost of igor.hpp.")
+    parser.add_argument("--reference", default="HEAD",
+                        help="git revision or path of the reference igor.hpp (default: HEAD)")
+    parser.add_argument("--cxx", default=os.environ.get("CXX", "c++"), help="C++ compiler")
+    parser.add_argument("--std", default="c++17", help="C++ standard")
+    parser.add_argument("--reps", type=int, default=20, help="number of repetitions")
+    parser.add_argument("--budget", type=float, default=None,
+                        help="fail if the current header is costlier than the reference by more than this fraction "
+                             "(in median time or in preprocessed lines)")
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        tu = os.path.join(tmp_dir, "include_cost.cpp")
+        with open(tu, "w") as f:
+            f.write("#include <igor/igor.hpp>\n")
+
+        ref_dir = os.path.join(tmp_dir, "reference")
+        try:
+            _setup_header(ref_dir, args.reference)
+        except RuntimeError as e:
+            print("error: {}".format(e), file=sys.stderr)
+            return 1
+
+        cur_dir = os.path.join(_REPO_ROOT, "include")
+
+        headers = (("reference", ref_dir), ("current", cur_dir))
+
+        # NOTE: interleave the compilations of the two headers, so that
+        # drifts in the machine's load affect both in the same way.
+        timings = {name: [] for name, _ in headers}
+        for _ in range(args.reps):
+            for name, inc_dir in headers:
+                timings[name].append(_time_syntax_only(args.cxx, args.std, inc_dir, tu))
+
+        results = {name: (statistics.median(timings[name]), _preprocessed_lines(args.cxx, args.std, inc_dir, tu))
+                   for name, inc_dir in headers}
+
+    print("{:<10} {:>12} {:>16}".format("header", "median (ms)", "preproc. lines"))
+    for name, (t, n_lines) in results.items():
+        print("{:<10} {:>12.2f} {:>16}".format(name, t * 1000., n_lines))
+
+    ratio = results["current"][0] / results["reference"][0]
+    print("current/reference time ratio: {:.3f}".format(ratio))
+    lines_ratio = results["current"][1] / results["reference"][1]
+    print("current/reference preproc. lines ratio: {:.3f}".format(lines_ratio))
+
+    if args.budget is not None and max(ratio, lines_ratio) > 1. + args.budget:
+        print("include cost budget exceeded", file=sys.stderr)
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,282 @@
+// Copyright 2018-2020 Francesco Biscani
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Runtime overhead of igor-based functions with respect to
+// functions taking plain positional arguments. This source is
+// compiled at different optimisation levels, and for each case
+// it reports the time and (where perf_event is available) the
+// number of instructions per call.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <utility>
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define IGOR_BENCH_HAVE_PERF_EVENT
+
+#endif
+
+#include <igor/igor.hpp>
+
+#if defined(__GNUC__)
+#define IGOR_BENCH_NOINLINE __attribute__((noinline))
+#else
+#define IGOR_BENCH_NOINLINE
+#endif
+
+#if !defined(IGOR_BENCH_OPT_LEVEL)
+#define IGOR_BENCH_OPT_LEVEL "unknown"
+#endif
+
+using namespace igor;
+
+IGOR_MAKE_NAMED_ARGUMENT(arg1);
+IGOR_MAKE_NAMED_ARGUMENT(arg2);
+
+namespace
+{
+
+// Prevent the compiler from optimising away x.
+template <typename T>
+inline void do_not_optimize(T &x)
+{
+#if defined(__GNUC__)
+    asm volatile("" : : "r,m"(x) : "memory");
+#else
+    static volatile T sink;
+    sink = x;
+#endif
+}
+
+// Instruction counter for the current thread. If perf_event
+// is not available, counting is disabled.
+class instruction_counter
+{
+public:
+    instruction_counter()
+    {
+#if defined(IGOR_BENCH_HAVE_PERF_EVENT)
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(perf_event_attr);
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        m_fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+    ~instruction_counter()
+    {
+#if defined(IGOR_BENCH_HAVE_PERF_EVENT)
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+#endif
+    }
+    instruction_counter(const instruction_counter &) = delete;
+    instruction_counter &operator=(const instruction_counter &) = delete;
+
+    bool available() const
+    {
+        return m_fd >= 0;
+    }
+    void start()
+    {
+#if defined(IGOR_BENCH_HAVE_PERF_EVENT)
+        if (available()) {
+            ::ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+    std::uint64_t stop()
+    {
+        std::uint64_t retval = 0;
+#if defined(IGOR_BENCH_HAVE_PERF_EVENT)
+        if (available()) {
+            ::ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (::read(m_fd, &retval, sizeof(retval)) != static_cast<::ssize_t>(sizeof(retval))) {
+                retval = 0;
+            }
+        }
+#endif
+        return retval;
+    }
+
+private:
+    int m_fd = -1;
+};
+
+// Run f() n times, and print the time and instructions per call.
+template <typename F>
+void run(instruction_counter &ic, const char *name, const char *variant, unsigned long n, F f)
+{
+    // Warm up.
+    for (unsigned long i = 0; i < n / 10u; ++i) {
+        f();
+    }
+
+    ic.start();
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < n; ++i) {
+        f();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const auto n_instr = ic.stop();
+
+    const auto ns = std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(n);
+
+    if (ic.available()) {
+        std::printf("%-4s %-14s %-11s %10.3f %14.1f\n", IGOR_BENCH_OPT_LEVEL, name, variant, ns,
+                    static_cast<double>(n_instr) / static_cast<double>(n));
+    } else {
+        std::printf("%-4s %-14s %-11s %10.3f %14s\n", IGOR_BENCH_OPT_LEVEL, name, variant, ns, "n/a");
+    }
+}
+
+// ints.
+IGOR_BENCH_NOINLINE int add_int(int a, int b)
+{
+    return a + b;
+}
+
+template <typename... Args>
+IGOR_BENCH_NOINLINE int add_int_igor(Args &&... args)
+{
+    parser p{args...};
+    return p(arg1) + p(arg2);
+}
+
+// Strings.
+IGOR_BENCH_NOINLINE std::size_t add_sizes(const std::string &a, const std::string &b)
+{
+    return a.size() + b.size();
+}
+
+template <typename... Args>
+IGOR_BENCH_NOINLINE std::size_t add_sizes_igor(Args &&... args)
+{
+    parser p{args...};
+    return p(arg1).size() + p(arg2).size();
+}
+
+// Move-only types.
+IGOR_BENCH_NOINLINE int consume(std::unique_ptr<int> &&a, std::unique_ptr<int> &&b)
+{
+    const auto x = std::move(a), y = std::move(b);
+    return *x + *y;
+}
+
+template <typename... Args>
+IGOR_BENCH_NOINLINE int consume_igor(Args &&... args)
+{
+    parser p{args...};
+    const auto x = std::move(p(arg1)), y = std::move(p(arg2));
+    return *x + *y;
+}
+
+// Initializer lists.
+IGOR_BENCH_NOINLINE int sum_lists(std::initializer_list<int> a, std::initializer_list<int> b)
+{
+    int retval = 0;
+    for (auto x : a) {
+        retval += x;
+    }
+    for (auto x : b) {
+        retval += x;
+    }
+    return retval;
+}
+
+template <typename... Args>
+IGOR_BENCH_NOINLINE int sum_lists_igor(Args &&... args)
+{
+    parser p{args...};
+    int retval = 0;
+    for (auto x : p(arg1)) {
+        retval += x;
+    }
+    for (auto x : p(arg2)) {
+        retval += x;
+    }
+    return retval;
+}
+
+} // namespace
+
+int main()
+{
+    constexpr unsigned long n = 10000000ul;
+
+    instruction_counter ic;
+
+    std::printf("%-4s %-14s %-11s %10s %14s\n", "opt", "case", "variant", "ns/call", "instr/call");
+
+    volatile int va = 1, vb = 2;
+    run(ic, "int", "positional", n, [&]() {
+        auto r = add_int(va, vb);
+        do_not_optimize(r);
+    });
+    run(ic, "int", "igor", n, [&]() {
+        auto r = add_int_igor(arg1 = static_cast<int>(va), arg2 = static_cast<int>(vb));
+        do_not_optimize(r);
+    });
+
+    const std::string sa = "hello", sb = "world";
+    run(ic, "string", "positional", n, [&]() {
+        auto r = add_sizes(sa, sb);
+        do_not_optimize(r);
+    });
+    run(ic, "string", "igor", n, [&]() {
+        auto r = add_sizes_igor(arg2 = sb, arg1 = sa);
+        do_not_optimize(r);
+    });
+
+    run(ic, "move_only", "positional", n / 10u, [&]() {
+        auto r = consume(std::make_unique<int>(va), std::make_unique<int>(vb));
+        do_not_optimize(r);
+    });
+    run(ic, "move_only", "igor", n / 10u, [&]() {
+        auto r = consume_igor(arg1 = std::make_unique<int>(va), arg2 = std::make_unique<int>(vb));
+        do_not_optimize(r);
+    });
+
+    run(ic, "init_list", "positional", n, [&]() {
+        auto r = sum_lists({va, vb, 3}, {4, vb});
+        do_not_optimize(r);
+    });
+    run(ic, "init_list", "igor", n, [&]() {
+        auto r = sum_lists_igor(arg1 = {static_cast<int>(va), static_cast<int>(vb), 3},
+                                arg2 = {4, static_cast<int>(vb)});
+        do_not_optimize(r);
+    });
+}
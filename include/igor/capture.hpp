@@ -0,0 +1,468 @@
+// Copyright 2018-2020 Francesco Biscani
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef IGOR_CAPTURE_HPP
+#define IGOR_CAPTURE_HPP
+
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+
+#include <igor/igor.hpp>
+
+namespace igor
+{
+
+namespace detail
+{
+
+// Wrapper signalling that capture() must store a
+// reference to the value of a named argument.
+template <typename Tag, typename T>
+struct by_ref_container {
+    T value;
+};
+
+template <typename T>
+struct is_by_ref_container : ::std::false_type {
+};
+
+template <typename Tag, typename T>
+struct is_by_ref_container<by_ref_container<Tag, T>> : ::std::true_type {
+};
+
+template <typename T>
+struct is_initializer_list : ::std::false_type {
+};
+
+template <typename T>
+struct is_initializer_list<::std::initializer_list<T>> : ::std::true_type {
+};
+
+// Type of the element stored in a bundle for the argument type T:
+// a tagged container holding a value (or a reference, if requested via
+// by_ref()) for named arguments, a value for unnamed arguments.
+// NOTE: arrays (including string literals, which cannot be told apart from
+// other arrays) are rejected, as they would decay to pointers which do not own
+// their values. T is not decayed beforehand for this reason.
+template <typename T>
+struct capture_elem {
+    static_assert(!::std::is_array_v<T>, "Arrays cannot be captured, as they would decay to pointers which do not own "
+                                         "their values (a std::string or a std::array can be used instead).");
+    using type = ::std::decay_t<T>;
+};
+
+template <typename Tag, typename T>
+struct capture_elem<tagged_container<Tag, T>> {
+    static_assert(!is_initializer_list<::std::decay_t<T>>::value,
+                  "Named arguments holding initializer lists cannot be captured, as they do not own their values.");
+    static_assert(!::std::is_array_v<::std::remove_reference_t<T>>,
+                  "Named arguments holding arrays cannot be captured, as they would decay to pointers which do not "
+                  "own their values (a std::string or a std::array can be used instead).");
+    using type = tagged_container<Tag, ::std::decay_t<T>>;
+};
+
+template <typename Tag, typename T>
+struct capture_elem<by_ref_container<Tag, T>> {
+    using type = tagged_container<Tag, T>;
+};
+
+template <typename T>
+using capture_elem_t = typename capture_elem<uncvref_t<T>>::type;
+
+// Type of the value stored in a bundle for the element T.
+template <typename T>
+struct captured_value {
+    using type = T;
+};
+
+template <typename Tag, typename T>
+struct captured_value<tagged_container<Tag, T>> {
+    using type = T;
+};
+
+template <typename T>
+using captured_value_t = typename captured_value<T>::type;
+
+// Value to be stored in a bundle for the argument x.
+template <typename T>
+IGOR_FORCE_INLINE constexpr decltype(auto) capture_init(T &&x)
+{
+    using U = uncvref_t<T>;
+
+    if constexpr (is_tagged_container_any<U>::value) {
+        if constexpr (::std::is_reference_v<tagged_value_t<U>>) {
+            // NOTE: the cast restores the original value category.
+            return static_cast<tagged_value_t<U>>(x.value);
+        } else {
+            return (static_cast<T &&>(x).value);
+        }
+    } else if constexpr (is_by_ref_container<U>::value) {
+        return x.value;
+    } else {
+        return static_cast<T &&>(x);
+    }
+}
+
+// Leaf of a bundle's storage. Empty values are stored
+// as base classes, so that they take up no space.
+template <::std::size_t I, typename T, bool = ::std::is_empty_v<T> && !::std::is_final_v<T>>
+struct capture_leaf {
+    T value;
+
+    IGOR_FORCE_INLINE constexpr T &get()
+    {
+        return value;
+    }
+    IGOR_FORCE_INLINE constexpr const T &get() const
+    {
+        return value;
+    }
+};
+
+template <::std::size_t I, typename T>
+struct capture_leaf<I, T, true> : T {
+    IGOR_FORCE_INLINE constexpr T &get()
+    {
+        return *this;
+    }
+    IGOR_FORCE_INLINE constexpr const T &get() const
+    {
+        return *this;
+    }
+};
+
+template <typename, typename...>
+struct bundle_storage;
+
+template <::std::size_t... Is, typename... Ts>
+struct bundle_storage<::std::index_sequence<Is...>, Ts...> : capture_leaf<Is, captured_value_t<Ts>>... {
+};
+
+template <::std::size_t I, typename T, bool E>
+IGOR_FORCE_INLINE constexpr T &bundle_get(capture_leaf<I, T, E> &l)
+{
+    return l.get();
+}
+
+template <::std::size_t I, typename T, bool E>
+IGOR_FORCE_INLINE constexpr const T &bundle_get(const capture_leaf<I, T, E> &l)
+{
+    return l.get();
+}
+
+// Reference to a value of type V stored in a bundle accessed as Self:
+// values are accessed with the constness and the value category of
+// Self, references are returned unchanged.
+template <typename Self, typename V>
+using bundle_ref_t = ::std::conditional_t<
+    ::std::is_reference_v<V>, V,
+    ::std::conditional_t<::std::is_lvalue_reference_v<Self>,
+                         ::std::conditional_t<::std::is_const_v<::std::remove_reference_t<Self>>, const V, V> &,
+                         ::std::conditional_t<::std::is_const_v<::std::remove_reference_t<Self>>, const V, V> &&>>;
+
+// Argument passed by a bundle accessed as Self for the element T:
+// tagged containers are re-created holding references to the stored values.
+template <typename T, typename Self>
+struct bundle_arg {
+    using type = bundle_ref_t<Self, T>;
+};
+
+template <typename Tag, typename T, typename Self>
+struct bundle_arg<tagged_container<Tag, T>, Self> {
+    using type = tagged_container<Tag, bundle_ref_t<Self, T>>;
+};
+
+template <typename T, typename Self>
+using bundle_arg_t = typename bundle_arg<T, Self>::type;
+
+template <typename T, typename Self, typename V>
+IGOR_FORCE_INLINE constexpr bundle_arg_t<T, Self> make_bundle_arg(V &x)
+{
+    if constexpr (is_tagged_container_any<T>::value) {
+        return bundle_arg_t<T, Self>{static_cast<bundle_ref_t<Self, captured_value_t<T>>>(x)};
+    } else {
+        return static_cast<bundle_arg_t<T, Self>>(x);
+    }
+}
+
+struct capture_tag {
+};
+
+} // namespace detail
+
+// Request capture() to store a reference to the
+// value of the named argument tc, rather than a copy.
+template <typename Tag, typename T>
+constexpr auto by_ref(const detail::tagged_container<Tag, T> &tc)
+{
+    static_assert(::std::is_lvalue_reference_v<T>,
+                  "Only named arguments referring to lvalues can be captured by reference.");
+
+    return detail::by_ref_container<Tag, T>{tc.value};
+}
+
+// Owning bundle of arguments, created by capture(). Ts are the
+// stored elements: tagged containers holding values (or lvalue references)
+// for the named arguments, and values for the unnamed arguments.
+template <typename... Ts>
+class bundle
+{
+    using storage_t = detail::bundle_storage<::std::index_sequence_for<Ts...>, Ts...>;
+
+    template <typename, typename...>
+    friend class bound_function;
+
+    template <typename... Us, typename... Args>
+    friend constexpr auto merge(const bundle<Us...> &, const Args &...);
+
+    template <typename... Args, ::std::size_t... Is>
+    IGOR_FORCE_INLINE static constexpr auto merge_impl(const bundle &defaults, ::std::index_sequence<Is...>,
+                                                       const Args &... args)
+    {
+        return ::igor::parser<Args..., detail::bundle_arg_t<detail::type_at_t<Is, Ts...>, const bundle &>...>(
+            args..., detail::make_bundle_arg<detail::type_at_t<Is, Ts...>, const bundle &>(
+                         detail::bundle_get<Is>(defaults.m_storage))...);
+    }
+
+    // NOTE: Is are the indices of the stored arguments to be passed to f,
+    // extra are additional arguments appended after the stored ones.
+    template <typename Self, typename F, ::std::size_t... Is, typename... Extra>
+    IGOR_FORCE_INLINE static constexpr decltype(auto) apply_impl(Self &&self, F &&f, ::std::index_sequence<Is...>,
+                                                                 Extra &&... extra)
+    {
+        return static_cast<F &&>(f)(
+            detail::make_bundle_arg<detail::type_at_t<Is, Ts...>, Self &&>(detail::bundle_get<Is>(self.m_storage))...,
+            static_cast<Extra &&>(extra)...);
+    }
+
+    template <typename Self, ::std::size_t... Is>
+    IGOR_FORCE_INLINE static constexpr auto parser_impl(Self &self, ::std::index_sequence<Is...>)
+    {
+        return ::igor::parser<detail::bundle_arg_t<Ts, Self &>...>(
+            detail::make_bundle_arg<Ts, Self &>(detail::bundle_get<Is>(self.m_storage))...);
+    }
+
+public:
+    // NOTE: this constructor is meant to be invoked by capture().
+    template <typename... Args>
+    IGOR_FORCE_INLINE constexpr explicit bundle(detail::capture_tag, Args &&... args)
+        : m_storage{{detail::capture_init(static_cast<Args &&>(args))}...}
+    {
+    }
+
+    // Invoke f with the stored arguments, in the original order. The named
+    // arguments are passed as tagged containers referring to the stored values,
+    // which are accessed with the constness and the value category of the bundle
+    // (thus an rvalue bundle allows to move the values out).
+    template <typename F>
+    IGOR_FORCE_INLINE constexpr decltype(auto) apply(F &&f) &
+    {
+        return bundle::apply_impl(*this, static_cast<F &&>(f), ::std::index_sequence_for<Ts...>{});
+    }
+    template <typename F>
+    IGOR_FORCE_INLINE constexpr decltype(auto) apply(F &&f) const &
+    {
+        return bundle::apply_impl(*this, static_cast<F &&>(f), ::std::index_sequence_for<Ts...>{});
+    }
+    template <typename F>
+    IGOR_FORCE_INLINE constexpr decltype(auto) apply(F &&f) &&
+    {
+        return bundle::apply_impl(static_cast<bundle &&>(*this), static_cast<F &&>(f),
+                                  ::std::index_sequence_for<Ts...>{});
+    }
+    template <typename F>
+    IGOR_FORCE_INLINE constexpr decltype(auto) apply(F &&f) const &&
+    {
+        return bundle::apply_impl(static_cast<const bundle &&>(*this), static_cast<F &&>(f),
+                                  ::std::index_sequence_for<Ts...>{});
+    }
+
+    // Create a parser over the stored arguments. The parser
+    // refers to the storage of the bundle, thus it must not outlive it.
+    IGOR_FORCE_INLINE constexpr auto parser() &
+    {
+        return bundle::parser_impl(*this, ::std::index_sequence_for<Ts...>{});
+    }
+    IGOR_FORCE_INLINE constexpr auto parser() const &
+    {
+        return bundle::parser_impl(*this, ::std::index_sequence_for<Ts...>{});
+    }
+    // NOTE: a parser over a temporary bundle would dangle.
+    void parser() && = delete;
+    void parser() const && = delete;
+
+private:
+    storage_t m_storage;
+};
+
+// Create an owning bundle from the arguments args, for deferred
+// or asynchronous execution. The values of the arguments are moved into
+// the bundle if they are rvalues and copied otherwise, unless a reference
+// to an lvalue is requested via by_ref(). Empty values take up no space
+// in the bundle.
+template <typename... Args>
+IGOR_FORCE_INLINE constexpr auto capture(Args &&... args)
+{
+    return bundle<detail::capture_elem_t<Args>...>(detail::capture_tag{}, static_cast<Args &&>(args)...);
+}
+
+namespace detail
+{
+
+template <typename... Ts>
+struct type_list {
+};
+
+// Check if the element T of a bundle bound to a function is kept
+// in a call with the arguments CallArgs: stored named arguments
+// are overridden by call-time named arguments with the same tag.
+template <typename T, typename... CallArgs>
+constexpr bool bind_keep()
+{
+    if constexpr (is_tagged_container_any<T>::value) {
+        using tag_set_t = tag_set<CallArgs...>;
+
+        return !contains_tag_id(sorted_tag_entries<CallArgs...>, tag_set_t::template lookup_id<typename T::tag_type>());
+    } else {
+        return true;
+    }
+}
+
+// Indices of the elements Ts of a bundle bound to
+// a function kept in a call with the arguments CallArgs.
+template <typename, typename>
+struct bind_kept;
+
+template <typename... Ts, typename... CallArgs>
+struct bind_kept<type_list<Ts...>, type_list<CallArgs...>> {
+    static constexpr ::std::size_t count
+        = (::std::size_t(0) + ... + static_cast<::std::size_t>(detail::bind_keep<Ts, CallArgs...>()));
+
+    static constexpr auto make_indices()
+    {
+        constexpr ct_array<bool, sizeof...(Ts)> keep{{detail::bind_keep<Ts, CallArgs...>()...}};
+
+        ct_array<::std::size_t, count> retval{};
+        for (::std::size_t i = 0, j = 0; i < sizeof...(Ts); ++i) {
+            if (keep[i]) {
+                retval[j++] = i;
+            }
+        }
+
+        return retval;
+    }
+
+    static constexpr auto indices = make_indices();
+};
+
+template <typename K, ::std::size_t... Is>
+constexpr auto bind_kept_sequence(::std::index_sequence<Is...>)
+{
+    return ::std::index_sequence<K::indices[Is]...>{};
+}
+
+} // namespace detail
+
+// Function with bound arguments, created by bind(). The stored arguments
+// Ts are held in a bundle, and they are passed to the function F before
+// the call-time arguments. The stored named arguments whose tags appear in
+// the call-time arguments are not passed (that is, call-time arguments
+// override the stored ones). The selection happens at compile time.
+// NOTE: F is stored in a leaf of a bundle's storage, so
+// that stateless callables take up no space.
+template <typename F, typename... Ts>
+class bound_function : detail::capture_leaf<0, F>
+{
+    template <typename Self, typename... CallArgs>
+    IGOR_FORCE_INLINE static constexpr decltype(auto) call_impl(Self &&self, CallArgs &&... cargs)
+    {
+        using kept_t = detail::bind_kept<detail::type_list<Ts...>, detail::type_list<CallArgs...>>;
+
+        return bundle<Ts...>::apply_impl(
+            static_cast<Self &&>(self).m_args, self.get(),
+            detail::bind_kept_sequence<kept_t>(::std::make_index_sequence<kept_t::count>{}),
+            static_cast<CallArgs &&>(cargs)...);
+    }
+
+public:
+    // NOTE: this constructor is meant to be invoked by bind().
+    template <typename G, typename... Args>
+    IGOR_FORCE_INLINE constexpr explicit bound_function(detail::capture_tag, G &&g, Args &&... args)
+        : detail::capture_leaf<0, F>{static_cast<G &&>(g)},
+          m_args(detail::capture_tag{}, static_cast<Args &&>(args)...)
+    {
+    }
+
+    // Invoke the function with the stored arguments followed by the
+    // arguments cargs. The stored arguments are passed with the constness
+    // and the value category of this.
+    template <typename... CallArgs>
+    IGOR_FORCE_INLINE constexpr decltype(auto) operator()(CallArgs &&... cargs) &
+    {
+        return bound_function::call_impl(*this, static_cast<CallArgs &&>(cargs)...);
+    }
+    template <typename... CallArgs>
+    IGOR_FORCE_INLINE constexpr decltype(auto) operator()(CallArgs &&... cargs) const &
+    {
+        return bound_function::call_impl(*this, static_cast<CallArgs &&>(cargs)...);
+    }
+    template <typename... CallArgs>
+    IGOR_FORCE_INLINE constexpr decltype(auto) operator()(CallArgs &&... cargs) &&
+    {
+        return bound_function::call_impl(static_cast<bound_function &&>(*this), static_cast<CallArgs &&>(cargs)...);
+    }
+
+private:
+    bundle<Ts...> m_args;
+};
+
+// Bind the arguments args to the function f. The arguments
+// are stored as in capture().
+template <typename F, typename... Args>
+IGOR_FORCE_INLINE constexpr auto bind(F &&f, Args &&... args)
+{
+    return bound_function<::std::decay_t<F>, detail::capture_elem_t<Args>...>(
+        detail::capture_tag{}, static_cast<F &&>(f), static_cast<Args &&>(args)...);
+}
+
+// Create a parser over the arguments args merged with the stored arguments
+// of the bundle defaults. The named arguments in args override the stored
+// named arguments with the same tags, which are excluded at compile time,
+// so that the parser holds a single slot for each tag (unless args themselves
+// contain duplicates). The unnamed arguments in defaults come after args.
+// The parser refers to the storage of defaults, thus it must not outlive it.
+template <typename... Ts, typename... Args>
+constexpr auto merge(const bundle<Ts...> &defaults, const Args &... args)
+{
+    using kept_t = detail::bind_kept<detail::type_list<Ts...>, detail::type_list<Args...>>;
+
+    return bundle<Ts...>::merge_impl(
+        defaults, detail::bind_kept_sequence<kept_t>(::std::make_index_sequence<kept_t::count>{}), args...);
+}
+
+// NOTE: a parser over a temporary bundle would dangle.
+template <typename... Ts, typename... Args>
+void merge(const bundle<Ts...> &&, const Args &...) = delete;
+
+} // namespace igor
+
+#endif
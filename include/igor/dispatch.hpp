@@ -0,0 +1,247 @@
+// Copyright 2018-2020 Francesco Biscani
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef IGOR_DISPATCH_HPP
+#define IGOR_DISPATCH_HPP
+
+#include <cstddef>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+#include <igor/igor.hpp>
+
+namespace igor
+{
+
+// Exception thrown by dispatch() when the runtime value
+// of a named argument is not one of the choices.
+class bad_dispatch : public ::std::exception
+{
+public:
+    const char *what() const noexcept override
+    {
+        return "The value of a named argument passed to igor::dispatch() is not one of the choices";
+    }
+};
+
+namespace detail
+{
+
+// Value of a dispatch choice as an integral.
+template <typename T>
+constexpr auto dispatch_integral(T x)
+{
+    if constexpr (::std::is_enum_v<T>) {
+        return static_cast<::std::underlying_type_t<T>>(x);
+    } else {
+        static_assert(::std::is_integral_v<T>, "The choices of a dispatch must be integrals or enums.");
+        return x;
+    }
+}
+
+// Offset of the value x from the smallest choice, computed
+// in modular arithmetic so that values smaller than the
+// smallest choice result in out-of-range offsets.
+template <auto Min, typename T>
+constexpr unsigned long long dispatch_offset(T x)
+{
+    return static_cast<unsigned long long>(detail::dispatch_integral(x))
+           - static_cast<unsigned long long>(detail::dispatch_integral(Min));
+}
+
+template <auto... Choices>
+constexpr auto dispatch_min()
+{
+    using int_t = decltype(detail::dispatch_integral(type_at_t<0, decltype(Choices)...>{}));
+    constexpr ct_array<int_t, sizeof...(Choices)> values{{detail::dispatch_integral(Choices)...}};
+
+    ::std::size_t retval = 0;
+    for (::std::size_t i = 1; i < values.size(); ++i) {
+        if (values[i] < values[retval]) {
+            retval = i;
+        }
+    }
+    return type_at_t<0, decltype(Choices)...>(values[retval]);
+}
+
+// Maximum size of a dispatch table.
+inline constexpr ::std::size_t dispatch_max_span = 1024;
+
+// Largest offset of the choices from the smallest choice.
+template <auto... Choices>
+constexpr unsigned long long dispatch_max_offset()
+{
+    constexpr auto min = detail::dispatch_min<Choices...>();
+    constexpr ct_array<unsigned long long, sizeof...(Choices)> offsets{{detail::dispatch_offset<min>(Choices)...}};
+
+    unsigned long long retval = 0;
+    for (::std::size_t i = 0; i < offsets.size(); ++i) {
+        if (offsets[i] > retval) {
+            retval = offsets[i];
+        }
+    }
+    return retval;
+}
+
+// Size of the dispatch table for the choices.
+// NOTE: the largest offset is checked against the maximum span
+// before adding 1, as the addition wraps around if the choices cover
+// the whole range of a 64-bit integral. Ranges which are too large
+// result in an empty table (and are rejected in dispatch()).
+template <auto... Choices>
+constexpr ::std::size_t dispatch_span()
+{
+    constexpr auto max_offset = detail::dispatch_max_offset<Choices...>();
+
+    return max_offset < dispatch_max_span ? static_cast<::std::size_t>(max_offset) + 1u : 0u;
+}
+
+// Offset of the runtime value x from the smallest choice Min. If x is an
+// integral or enum whose value cannot be represented in the type of the
+// choices, an out-of-range offset is returned (rather than dispatching
+// on the narrowed value). A floating-point x is compared with each of
+// the choices, so that it is dispatched only if it is equal to one of
+// them (rather than being truncated).
+template <auto Min, auto... Choices, typename T>
+constexpr unsigned long long dispatch_value_offset(const T &x)
+{
+    if constexpr (::std::is_integral_v<T> || ::std::is_enum_v<T>) {
+        const auto xi = detail::dispatch_integral(x);
+        using xi_t = decltype(xi);
+        using ci_t = decltype(detail::dispatch_integral(Min));
+
+        const auto ci = static_cast<ci_t>(xi);
+        if (static_cast<xi_t>(ci) != xi) {
+            return ~0ull;
+        }
+        if constexpr (::std::is_signed_v<xi_t> && !::std::is_signed_v<ci_t>) {
+            if (xi < 0) {
+                return ~0ull;
+            }
+        } else if constexpr (!::std::is_signed_v<xi_t> && ::std::is_signed_v<ci_t>) {
+            if (ci < 0) {
+                return ~0ull;
+            }
+        }
+
+        return detail::dispatch_offset<Min>(ci);
+    } else {
+        static_assert(::std::is_floating_point_v<T>,
+                      "The value of a dispatched named argument must be an integral, an enum or a floating-point value.");
+
+        // NOTE: the equality is spelled via <= and >= in order
+        // not to trigger -Wfloat-equal in user code.
+        unsigned long long retval = ~0ull;
+        static_cast<void>((... || (x <= static_cast<T>(detail::dispatch_integral(Choices))
+                                   && x >= static_cast<T>(detail::dispatch_integral(Choices))
+                                   && (retval = detail::dispatch_offset<Min>(Choices), true))));
+        return retval;
+    }
+}
+
+template <auto Min, auto... Choices>
+constexpr bool dispatch_is_choice(unsigned long long offset)
+{
+    return (... || (detail::dispatch_offset<Min>(Choices) == offset));
+}
+
+// Entries of the dispatch table.
+template <auto V, typename R, typename F>
+R dispatch_call(F &&f)
+{
+    return static_cast<F &&>(f)(ct<V>);
+}
+
+template <typename R, typename F>
+[[noreturn]] R dispatch_fail(F &&)
+{
+    throw bad_dispatch{};
+}
+
+// NOTE: f is instantiated only for the values which are among the choices.
+template <bool IsChoice, auto V, typename R, typename F>
+constexpr auto dispatch_entry()
+{
+    if constexpr (IsChoice) {
+        return &detail::dispatch_call<V, R, F>;
+    } else {
+        return &detail::dispatch_fail<R, F>;
+    }
+}
+
+// Dense table of the entries for the values in the
+// [min, max] range of the choices. The values which are not
+// among the choices are mapped to dispatch_fail().
+template <typename R, typename F, typename T, T Min, auto... Choices, ::std::size_t... Is>
+constexpr auto make_dispatch_table(::std::index_sequence<Is...>)
+{
+    using int_t = decltype(detail::dispatch_integral(Min));
+
+    return ct_array<R (*)(F &&), sizeof...(Is)>{
+        {detail::dispatch_entry<detail::dispatch_is_choice<Min, Choices...>(Is),
+                                static_cast<T>(static_cast<int_t>(detail::dispatch_integral(Min)
+                                                                  + static_cast<int_t>(Is))),
+                                R, F>()...}};
+}
+
+template <typename R, typename F, auto... Choices>
+inline constexpr auto dispatch_table
+    = detail::make_dispatch_table<R, F, type_at_t<0, decltype(Choices)...>, detail::dispatch_min<Choices...>(),
+                                  Choices...>(::std::make_index_sequence<detail::dispatch_span<Choices...>()>{});
+
+} // namespace detail
+
+// Invoke f with the runtime value of the named argument narg in the
+// parser p converted to a compile-time value: if the value is equal
+// to one of the Choices, f is invoked with ct<Choice>. The selection
+// is performed via a single lookup in a dense table of function
+// pointers, spanning the range of the choices. If the value is not
+// one of the choices, bad_dispatch is thrown. The choices must be
+// integral or enum values of the same type, and f must return the same
+// type for all the choices.
+template <auto... Choices, typename... ParseArgs, typename Tag, typename ExplicitType, typename F>
+inline decltype(auto) dispatch(const parser<ParseArgs...> &p, const named_argument<Tag, ExplicitType> &narg, F &&f)
+{
+    static_assert(sizeof...(Choices) > 0u, "At least one choice must be provided to dispatch().");
+
+    using choice_t = detail::type_at_t<0, decltype(Choices)...>;
+    static_assert((... && detail::is_same_v<decltype(Choices), choice_t>),
+                  "The choices of a dispatch must all have the same type.");
+    static_assert(detail::dispatch_max_offset<Choices...>() < detail::dispatch_max_span,
+                  "The range of the choices of a dispatch is too large for a dense dispatch table.");
+
+    static_assert(detail::find_slot<ParseArgs...>(detail::tag_set<ParseArgs...>::template lookup_id<Tag>())
+                      != detail::n_named_arguments<ParseArgs...>,
+                  "A named argument must be present in order to be dispatched.");
+
+    using ret_t = decltype(static_cast<F &&>(f)(ct<detail::dispatch_min<Choices...>()>));
+    static_assert((... && detail::is_same_v<decltype(static_cast<F &&>(f)(ct<Choices>)), ret_t>),
+                  "The visitor of a dispatch must return the same type for all the choices.");
+
+    constexpr auto &table = detail::dispatch_table<ret_t, F, Choices...>;
+    const auto idx = detail::dispatch_value_offset<detail::dispatch_min<Choices...>(), Choices...>(p(narg));
+
+    return (idx < table.size() ? table[idx] : &detail::dispatch_fail<ret_t, F>)(static_cast<F &&>(f));
+}
+
+} // namespace igor
+
+#endif
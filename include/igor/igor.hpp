@@ -23,26 +23,42 @@
 
 #include <cstddef>
 #include <initializer_list>
-#include <tuple>
 #include <type_traits>
 #include <utility>
 
-// NOTE: a possible strategy to improve performance
-// with large number of arguments (i.e., avoiding
-// quadratic complexity):
-// - associate a compile-time unique ID to every named argument
-//   based on its Tag. This can be done, e.g., via taking
-//   the address of an inline variable template (note that this
-//   does not work on GCC due to a bug, can be worked around
-//   by making the unique ID a string_view encoding the type
-//   name, see
-//   https://stackoverflow.com/questions/81870/is-it-possible-to-print-a-variables-type-in-standard-c/56766138#56766138);
-// - build and sort a std::array containing all the IDs
-//   of the named arguments appearing in a variadic pack,
-//   and do binary search in the array for log(n) complexity.
-//
-// Of course, hashing would be even better. E.g., see the frozen library:
-// https://github.com/serge-sans-paille/frozen
+// Detect the availability of compiler builtins which avoid
+// the instantiation of class templates in pack manipulations.
+// The builtins can be disabled (e.g., for testing the portable
+// fallbacks) by defining IGOR_DISABLE_BUILTINS.
+#if !defined(IGOR_DISABLE_BUILTINS) && defined(__has_builtin)
+
+#if __has_builtin(__type_pack_element)
+#define IGOR_HAVE_TYPE_PACK_ELEMENT
+#endif
+
+#if __has_builtin(__is_same)
+#define IGOR_HAVE_IS_SAME
+#endif
+
+#endif
+
+// Performance mode for unoptimised builds: if IGOR_ENABLE_FORCE_INLINE
+// is defined, the functions in the construction and fetch paths
+// of the parser are forcibly inlined, so that they do not result
+// in a chain of function calls at -O0.
+#if defined(IGOR_ENABLE_FORCE_INLINE)
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define IGOR_FORCE_INLINE __forceinline
+#else
+#define IGOR_FORCE_INLINE __attribute__((always_inline))
+#endif
+
+#else
+
+#define IGOR_FORCE_INLINE
+
+#endif
 
 namespace igor
 {
@@ -54,11 +70,20 @@ namespace detail
 template <typename T>
 using uncvref_t = ::std::remove_cv_t<::std::remove_reference_t<T>>;
 
+// Type comparison.
+template <typename T, typename U>
+inline constexpr bool is_same_v =
+#if defined(IGOR_HAVE_IS_SAME)
+    __is_same(T, U);
+#else
+    ::std::is_same_v<T, U>;
+#endif
+
 // The value returned by named_argument's assignment operator.
-// T will always be a reference of some kind.
+// T will be a reference of some kind, unless the named argument
+// is explicitly typed with a value type.
 template <typename Tag, typename T>
 struct tagged_container {
-    static_assert(::std::is_reference_v<T>, "T must always be a reference.");
     using tag_type = Tag;
     T value;
 };
@@ -69,55 +94,76 @@ struct tagged_container {
 template <typename Tag, typename ExplicitType = void, typename VoidCondition = void>
 struct named_argument {
     // NOTE: make sure this does not interfere with the copy/move assignment operators.
-    template <typename T, ::std::enable_if_t<!::std::is_same_v<named_argument, detail::uncvref_t<T>>, int> = 0>
-    constexpr auto operator=(T &&x) const
+    // NOTE: here and elsewhere in the construction and fetch paths,
+    // use static_cast instead of std::forward()/std::move(), which
+    // would be function calls in unoptimised builds.
+    template <typename T, ::std::enable_if_t<!detail::is_same_v<named_argument, detail::uncvref_t<T>>, int> = 0>
+    IGOR_FORCE_INLINE constexpr auto operator=(T &&x) const
     {
-        return detail::tagged_container<Tag, T &&>{::std::forward<T>(x)};
+        return detail::tagged_container<Tag, T &&>{static_cast<T &&>(x)};
     }
 
     // Add overloads for std::initializer_list as well.
     template <typename T>
-    constexpr auto operator=(const ::std::initializer_list<T> &l) const
+    IGOR_FORCE_INLINE constexpr auto operator=(const ::std::initializer_list<T> &l) const
     {
         return detail::tagged_container<Tag, const ::std::initializer_list<T> &>{l};
     }
     template <typename T>
-    constexpr auto operator=(::std::initializer_list<T> &l) const
+    IGOR_FORCE_INLINE constexpr auto operator=(::std::initializer_list<T> &l) const
     {
         return detail::tagged_container<Tag, ::std::initializer_list<T> &>{l};
     }
     template <typename T>
-    constexpr auto operator=(::std::initializer_list<T> &&l) const
+    IGOR_FORCE_INLINE constexpr auto operator=(::std::initializer_list<T> &&l) const
     {
-        return detail::tagged_container<Tag, ::std::initializer_list<T> &&>{::std::move(l)};
+        return detail::tagged_container<Tag, ::std::initializer_list<T> &&>{
+            static_cast<::std::initializer_list<T> &&>(l)};
     }
     template <typename T>
-    constexpr auto operator=(const ::std::initializer_list<T> &&l) const
+    IGOR_FORCE_INLINE constexpr auto operator=(const ::std::initializer_list<T> &&l) const
     {
-        return detail::tagged_container<Tag, const ::std::initializer_list<T> &&>{::std::move(l)};
+        return detail::tagged_container<Tag, const ::std::initializer_list<T> &&>{
+            static_cast<const ::std::initializer_list<T> &&>(l)};
     }
 };
 
+namespace detail
+{
+
+// Check if an object of type T can be assigned to a named argument
+// explicitly typed as ExplicitType without implicit conversions. If ExplicitType
+// is a reference, T && must be the same as ExplicitType. Otherwise, the
+// value will be stored by copy/move in the tagged container, and T
+// must be ExplicitType (up to cv and reference qualifiers).
+template <typename T, typename ExplicitType>
+inline constexpr bool is_explicit_match_v
+    = ::std::is_reference_v<ExplicitType> ? is_same_v<T &&, ExplicitType> : is_same_v<uncvref_t<T>, ExplicitType>;
+
+} // namespace detail
+
+// NOTE: ExplicitType can be either a reference or a value type. In the latter
+// case, the value is stored by value in the tagged container and in the parser,
+// and any conversion happens once at the call site.
 template <typename Tag, typename ExplicitType>
-struct named_argument<Tag, ExplicitType, std::enable_if_t<!std::is_same_v<ExplicitType, void>>> {
-    static_assert(::std::is_reference_v<ExplicitType>, "ExplicitType must always be a reference.");
+struct named_argument<Tag, ExplicitType, std::enable_if_t<!detail::is_same_v<ExplicitType, void>>> {
     using value_type = ExplicitType;
 
     // NOTE: disable implicit conversion, deduced type needs to be the same as explicit type.
-    template <typename T, ::std::enable_if_t<::std::is_same_v<T &&, ExplicitType>, int> = 0>
-    constexpr auto operator=(T &&x) const
+    template <typename T, ::std::enable_if_t<detail::is_explicit_match_v<T, ExplicitType>, int> = 0>
+    IGOR_FORCE_INLINE constexpr auto operator=(T &&x) const
     {
-        return detail::tagged_container<Tag, ExplicitType>{::std::forward<T>(x)};
+        return detail::tagged_container<Tag, ExplicitType>{static_cast<T &&>(x)};
     }
 
     // NOTE: enable implicit conversion with curly braces
     // and copy-list/aggregate initialization with double curly braces.
-    constexpr auto operator=(detail::tagged_container<Tag, ExplicitType> &&tc) const
+    IGOR_FORCE_INLINE constexpr auto operator=(detail::tagged_container<Tag, ExplicitType> &&tc) const
     {
-        return std::move(tc);
+        return static_cast<detail::tagged_container<Tag, ExplicitType> &&>(tc);
     }
 
-    template <typename T, ::std::enable_if_t<!::std::is_same_v<T &&, ExplicitType>, int> = 0>
+    template <typename T, ::std::enable_if_t<!detail::is_explicit_match_v<T, ExplicitType>, int> = 0>
     auto operator=(T &&) const = delete; // please use {...} to typed argument implicit conversion
 };
 
@@ -133,6 +179,157 @@ inline constexpr not_provided_t not_provided;
 namespace detail
 {
 
+// Wrapper for a callable whose result is used as the value of a
+// named argument. The callable is invoked by the parser each time
+// the named argument is fetched, and never if it is not fetched.
+template <typename F>
+struct lazy_value {
+    IGOR_FORCE_INLINE constexpr decltype(auto) operator()() const
+    {
+        return f();
+    }
+    F f;
+};
+
+template <typename T>
+struct is_lazy_value : ::std::false_type {
+};
+
+template <typename F>
+struct is_lazy_value<lazy_value<F>> : ::std::true_type {
+};
+
+} // namespace detail
+
+// Create a lazy value from the callable f, for use as in
+// arg = lazy(f). The callable is stored by value.
+template <typename F>
+IGOR_FORCE_INLINE constexpr auto lazy(F &&f)
+{
+    return detail::lazy_value<detail::uncvref_t<F>>{static_cast<F &&>(f)};
+}
+
+// Compile-time value, for use as in arg = ct<V>. The value
+// of the named argument can then be fetched as a constant expression
+// via parser::constant().
+template <auto V>
+inline constexpr ::std::integral_constant<decltype(V), V> ct{};
+
+// Compile-time unique ID of a tag type. This is a minimal constexpr
+// string view over the compiler's spelling of the tag's name.
+// NOTE: we do not use std::string_view because <string_view>
+// is expensive to include.
+class tag_id_t
+{
+public:
+    tag_id_t() = default;
+    constexpr explicit tag_id_t(const char *data, ::std::size_t size) : m_data(data), m_size(size) {}
+
+    constexpr const char *data() const
+    {
+        return m_data;
+    }
+    constexpr ::std::size_t size() const
+    {
+        return m_size;
+    }
+    constexpr bool empty() const
+    {
+        return m_size == 0u;
+    }
+
+    // Find the first occurrence of s in this, returning its position
+    // (or size() if s is not found).
+    constexpr ::std::size_t find(tag_id_t s) const
+    {
+        for (::std::size_t i = 0; i + s.m_size <= m_size; ++i) {
+            if (tag_id_t(m_data + i, s.m_size) == s) {
+                return i;
+            }
+        }
+
+        return m_size;
+    }
+
+    // Lexicographic comparison.
+    friend constexpr bool operator<(tag_id_t a, tag_id_t b)
+    {
+        for (::std::size_t i = 0; i < a.m_size && i < b.m_size; ++i) {
+            if (a.m_data[i] != b.m_data[i]) {
+                return a.m_data[i] < b.m_data[i];
+            }
+        }
+
+        return a.m_size < b.m_size;
+    }
+    friend constexpr bool operator==(tag_id_t a, tag_id_t b)
+    {
+        if (a.m_size != b.m_size) {
+            return false;
+        }
+
+        for (::std::size_t i = 0; i < a.m_size; ++i) {
+            if (a.m_data[i] != b.m_data[i]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+    friend constexpr bool operator!=(tag_id_t a, tag_id_t b)
+    {
+        return !(a == b);
+    }
+
+private:
+    const char *m_data = nullptr;
+    ::std::size_t m_size = 0;
+};
+
+namespace detail
+{
+
+// Helper to fetch the compiler-generated signature of a function
+// template instantiation, which contains the name of T.
+template <typename T>
+constexpr tag_id_t type_signature()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return tag_id_t(__FUNCSIG__, sizeof(__FUNCSIG__) - 1u);
+#else
+    return tag_id_t(__PRETTY_FUNCTION__, sizeof(__PRETTY_FUNCTION__) - 1u);
+#endif
+}
+
+// Locate the name of T inside type_signature<T>() by probing
+// with a type whose name we know.
+inline constexpr tag_id_t type_signature_probe = type_signature<double>();
+inline constexpr ::std::size_t type_signature_prefix = type_signature_probe.find(tag_id_t("double", 6));
+inline constexpr ::std::size_t type_signature_suffix = type_signature_probe.size() - type_signature_prefix - 6u;
+
+// NOTE: we use a string encoding the type name rather than the address
+// of an inline variable template because the latter cannot be ordered
+// in a constant expression (and the addresses are not even guaranteed to
+// compare unequal on GCC, due to a compiler bug). See:
+// https://stackoverflow.com/questions/81870/is-it-possible-to-print-a-variables-type-in-standard-c/56766138#56766138
+template <typename T>
+constexpr tag_id_t type_name()
+{
+    constexpr auto sig = type_signature<T>();
+
+    return tag_id_t(sig.data() + type_signature_prefix, sig.size() - type_signature_prefix - type_signature_suffix);
+}
+
+} // namespace detail
+
+// Compile-time unique ID for the tag type Tag. IDs are totally ordered,
+// which allows to sort them and look them up via binary search.
+template <typename Tag>
+inline constexpr tag_id_t tag_id = detail::type_name<Tag>();
+
+namespace detail
+{
+
 // Type trait to detect if T is a tagged container with tag Tag (and any type as second parameter).
 template <typename Tag, typename T>
 struct is_tagged_container : ::std::false_type {
@@ -152,24 +349,351 @@ template <typename Tag, typename T>
 struct is_tagged_container_any<tagged_container<Tag, T>> : ::std::true_type {
 };
 
-// Implementation of parsers' constructor.
-// This function will take a set of input arguments
-// (as const ref) and will filter out the named arguments
-// (which are returned as a tuple of const references).
+// Minimal constexpr-friendly array class.
+template <typename T, ::std::size_t N>
+struct ct_array {
+    // NOTE: zero-sized arrays are not allowed.
+    T data[N == 0u ? 1u : N];
+
+    static constexpr ::std::size_t size()
+    {
+        return N;
+    }
+    constexpr const T &operator[](::std::size_t i) const
+    {
+        return data[i];
+    }
+    constexpr T &operator[](::std::size_t i)
+    {
+        return data[i];
+    }
+};
+
+// Number of named arguments in Args.
 template <typename... Args>
-constexpr inline auto build_parser_tuple(const Args &... args)
+inline constexpr ::std::size_t n_named_arguments
+    = (::std::size_t(0) + ... + static_cast<::std::size_t>(is_tagged_container_any<uncvref_t<Args>>::value));
+
+// Fetch the I-th type in a pack.
+#if defined(IGOR_HAVE_TYPE_PACK_ELEMENT)
+
+template <::std::size_t I, typename... Ts>
+using type_at_t = __type_pack_element<I, Ts...>;
+
+#else
+
+// Non-recursive fallback implementation.
+template <::std::size_t I, typename T>
+struct indexed_type {
+    using type = T;
+};
+
+template <typename, typename...>
+struct indexed_pack;
+
+template <::std::size_t... Is, typename... Ts>
+struct indexed_pack<::std::index_sequence<Is...>, Ts...> : indexed_type<Is, Ts>... {
+};
+
+template <::std::size_t I, typename T>
+indexed_type<I, T> select_indexed_type(const indexed_type<I, T> &);
+
+template <::std::size_t I, typename... Ts>
+using type_at_t = typename decltype(
+    detail::select_indexed_type<I>(::std::declval<indexed_pack<::std::index_sequence_for<Ts...>, Ts...>>()))::type;
+
+#endif
+
+// An entry in the sorted list of tag IDs of a pack: the ID of the tag, and
+// the position of the named argument within the pack.
+struct tag_entry {
+    tag_id_t id;
+    ::std::size_t index;
+};
+
+// Tag ID of the argument type T, if T is a named argument. Otherwise,
+// an empty string.
+template <typename T>
+constexpr tag_id_t arg_tag_id()
 {
-    [[maybe_unused]] auto filter_na = [](const auto &x) {
-        if constexpr (is_tagged_container_any<uncvref_t<decltype(x)>>::value) {
-            return ::std::forward_as_tuple(x);
+    if constexpr (is_tagged_container_any<T>::value) {
+        return tag_id<typename T::tag_type>;
+    } else {
+        return {};
+    }
+}
+
+// Stable sort of tag entries by ID (bottom-up merge sort,
+// n log(n) complexity).
+template <::std::size_t N>
+constexpr void sort_tag_entries(ct_array<tag_entry, N> &a)
+{
+    ct_array<tag_entry, N> tmp{};
+
+    for (::std::size_t width = 1; width < N; width *= 2u) {
+        for (::std::size_t lo = 0; lo < N; lo += 2u * width) {
+            const auto mid = (lo + width < N) ? lo + width : N;
+            const auto hi = (lo + 2u * width < N) ? lo + 2u * width : N;
+
+            auto i = lo, j = mid, k = lo;
+            while (i < mid && j < hi) {
+                // NOTE: take from the left run on ties for stability.
+                tmp[k++] = (a[j].id < a[i].id) ? a[j++] : a[i++];
+            }
+            while (i < mid) {
+                tmp[k++] = a[i++];
+            }
+            while (j < hi) {
+                tmp[k++] = a[j++];
+            }
+        }
+
+        for (::std::size_t i = 0; i < N; ++i) {
+            a[i] = tmp[i];
+        }
+    }
+}
+
+// Build the list of the tag entries of the named arguments
+// in Args, sorted by tag ID.
+template <typename... Args>
+constexpr auto make_sorted_tag_entries()
+{
+    constexpr ct_array<tag_id_t, sizeof...(Args)> ids{{arg_tag_id<uncvref_t<Args>>()...}};
+    constexpr ct_array<bool, sizeof...(Args)> named{{is_tagged_container_any<uncvref_t<Args>>::value...}};
+
+    ct_array<tag_entry, n_named_arguments<Args...>> retval{};
+
+    for (::std::size_t i = 0, j = 0; i < sizeof...(Args); ++i) {
+        if (named[i]) {
+            retval[j++] = tag_entry{ids[i], i};
+        }
+    }
+
+    sort_tag_entries(retval);
+
+    return retval;
+}
+
+template <typename... Args>
+inline constexpr auto unchecked_sorted_tag_entries = make_sorted_tag_entries<Args...>();
+
+// Positions in unchecked_sorted_tag_entries<Args...> of the entries
+// whose ID is equal to the ID of the previous entry.
+template <::std::size_t M, ::std::size_t N>
+constexpr auto make_equal_id_positions(const ct_array<tag_entry, N> &a)
+{
+    ct_array<::std::size_t, M> retval{};
+    for (::std::size_t i = 1, j = 0; i < N; ++i) {
+        if (a[i].id == a[i - 1u].id) {
+            retval[j++] = i;
+        }
+    }
+
+    return retval;
+}
+
+template <::std::size_t N>
+constexpr ::std::size_t count_equal_ids(const ct_array<tag_entry, N> &a)
+{
+    ::std::size_t retval = 0;
+    for (::std::size_t i = 1; i < N; ++i) {
+        retval += static_cast<::std::size_t>(a[i].id == a[i - 1u].id);
+    }
+
+    return retval;
+}
+
+template <typename... Args>
+inline constexpr auto equal_id_positions
+    = make_equal_id_positions<count_equal_ids(unchecked_sorted_tag_entries<Args...>)>(
+        unchecked_sorted_tag_entries<Args...>);
+
+// Tag type of the I-th argument in Args.
+template <::std::size_t I, typename... Args>
+using arg_tag_t = typename uncvref_t<type_at_t<I, Args...>>::tag_type;
+
+// Check that the named arguments in Args sharing a tag ID have the
+// same tag type.
+template <typename... Args, ::std::size_t... Ks>
+constexpr bool equal_ids_same_tags(::std::index_sequence<Ks...>)
+{
+    constexpr auto &a = unchecked_sorted_tag_entries<Args...>;
+    constexpr auto &pos = equal_id_positions<Args...>;
+
+    return (true && ... && is_same_v<arg_tag_t<a[pos[Ks] - 1u].index, Args...>, arg_tag_t<a[pos[Ks]].index, Args...>>);
+}
+
+// NOTE: tag IDs are built from the compiler's spelling of the tag
+// types, and distinct types may be spelled the same way (e.g., local
+// classes with the same name declared in different lambdas of
+// the same function). Such tags cannot be told apart by ID, thus
+// we reject them rather than silently mixing them up.
+template <typename... Args>
+constexpr auto make_checked_sorted_tag_entries()
+{
+    static_assert(
+        detail::equal_ids_same_tags<Args...>(::std::make_index_sequence<equal_id_positions<Args...>.size()>{}),
+        "Distinct tag types with the same name cannot be used together as named arguments.");
+
+    return unchecked_sorted_tag_entries<Args...>;
+}
+
+template <typename... Args>
+inline constexpr auto sorted_tag_entries = make_checked_sorted_tag_entries<Args...>();
+
+// Locate, via binary search, the first entry in the sorted array a
+// whose ID is not less than id.
+template <::std::size_t N>
+constexpr ::std::size_t lower_bound_tag_entry(const ct_array<tag_entry, N> &a, tag_id_t id)
+{
+    ::std::size_t lo = 0, hi = N;
+
+    while (lo < hi) {
+        const auto mid = lo + (hi - lo) / 2u;
+        if (a[mid].id < id) {
+            lo = mid + 1u;
         } else {
-            return ::std::tuple{};
+            hi = mid;
         }
-    };
+    }
+
+    return lo;
+}
+
+// Check if the tag with ID id appears in the sorted array a.
+template <::std::size_t N>
+constexpr bool contains_tag_id(const ct_array<tag_entry, N> &a, tag_id_t id)
+{
+    const auto idx = detail::lower_bound_tag_entry(a, id);
+
+    return idx != N && a[idx].id == id;
+}
+
+// Marker base classes for the tag type Tag.
+template <typename Tag>
+struct tag_marker {
+};
+
+template <::std::size_t I, typename Tag>
+struct indexed_tag_marker : tag_marker<Tag> {
+};
+
+// Tag type of the argument type T, if T is a named argument. Otherwise, void.
+template <typename T>
+struct arg_tag {
+    using type = void;
+};
+
+template <typename Tag, typename T>
+struct arg_tag<tagged_container<Tag, T>> {
+    using type = Tag;
+};
+
+// The set of the tag types in the pack Args, as a class deriving
+// from a marker for each tag type.
+template <typename, typename...>
+struct tag_set_impl;
+
+template <::std::size_t... Is, typename... Args>
+struct tag_set_impl<::std::index_sequence<Is...>, Args...>
+    : indexed_tag_marker<Is, typename arg_tag<uncvref_t<Args>>::type>... {
+    // Tag ID of Tag, for lookups in the pack Args. If a named argument
+    // in Args has the same tag ID as Tag, check that it also has the same
+    // tag type (see the note in make_checked_sorted_tag_entries()).
+    // NOTE: this is a member function template (rather than a function template
+    // parametrised over Tag and Args) in order to avoid one instantiation
+    // over the whole pack per lookup.
+    template <typename Tag>
+    static constexpr tag_id_t lookup_id()
+    {
+        static_assert(::std::is_base_of_v<tag_marker<Tag>, tag_set_impl>
+                          || !detail::contains_tag_id(sorted_tag_entries<Args...>, tag_id<Tag>),
+                      "Distinct tag types with the same name cannot be told apart in a lookup.");
+
+        return tag_id<Tag>;
+    }
+};
+
+template <typename... Args>
+using tag_set = tag_set_impl<::std::index_sequence_for<Args...>, Args...>;
+
+// Build the slot map for the pack Args: for each entry in
+// sorted_tag_entries<Args...>, the position of the corresponding
+// named argument in the parser's storage.
+template <typename... Args>
+constexpr auto make_slot_map()
+{
+    constexpr ct_array<bool, sizeof...(Args)> named{{is_tagged_container_any<uncvref_t<Args>>::value...}};
+
+    // Position of each argument among the named arguments.
+    ct_array<::std::size_t, sizeof...(Args)> named_pos{};
+    for (::std::size_t i = 0, j = 0; i < sizeof...(Args); ++i) {
+        named_pos[i] = j;
+        j += static_cast<::std::size_t>(named[i]);
+    }
+
+    ct_array<::std::size_t, n_named_arguments<Args...>> retval{};
+    for (::std::size_t k = 0; k < n_named_arguments<Args...>; ++k) {
+        retval[k] = named_pos[sorted_tag_entries<Args...>[k].index];
+    }
+
+    return retval;
+}
+
+template <typename... Args>
+inline constexpr auto slot_map = make_slot_map<Args...>();
+
+// Position in the parser's storage of the first named argument
+// with tag ID id in Args. If no such argument exists, the total
+// number of named arguments in Args will be returned.
+template <typename... Args>
+constexpr ::std::size_t find_slot(tag_id_t id)
+{
+    const auto idx = detail::lower_bound_tag_entry(sorted_tag_entries<Args...>, id);
+
+    if (idx != n_named_arguments<Args...> && sorted_tag_entries<Args...>[idx].id == id) {
+        return slot_map<Args...>[idx];
+    } else {
+        return n_named_arguments<Args...>;
+    }
+}
+
+// Number of named arguments with tag ID id in Args.
+template <typename... Args>
+constexpr ::std::size_t count_tag_id(tag_id_t id)
+{
+    const auto idx = detail::lower_bound_tag_entry(sorted_tag_entries<Args...>, id);
+
+    ::std::size_t retval = 0;
+    while (idx + retval != n_named_arguments<Args...> && sorted_tag_entries<Args...>[idx + retval].id == id) {
+        ++retval;
+    }
 
-    return ::std::tuple_cat(filter_na(args)...);
+    return retval;
 }
 
+// Positions in the parser's storage of all the named
+// arguments with tag Tag in Args, in call order.
+// NOTE: the sort of the tag entries is stable, thus
+// the entries with the same tag are in call order.
+template <typename Tag, typename... Args>
+constexpr auto make_tag_slots()
+{
+    constexpr auto id = detail::tag_set<Args...>::template lookup_id<Tag>();
+    constexpr auto first = detail::lower_bound_tag_entry(sorted_tag_entries<Args...>, id);
+
+    ct_array<::std::size_t, detail::count_tag_id<Args...>(id)> retval{};
+    for (::std::size_t i = 0; i < retval.size(); ++i) {
+        retval[i] = slot_map<Args...>[first + i];
+    }
+
+    return retval;
+}
+
+template <typename Tag, typename... Args>
+inline constexpr auto tag_slots = make_tag_slots<Tag, Args...>();
+
 } // namespace detail
 
 // NOTE: implement some of the parser functionality as free functions,
@@ -179,19 +703,27 @@ constexpr inline auto build_parser_tuple(const Args &... args)
 template <typename... Args, typename Tag, typename ExplicitType>
 constexpr bool has([[maybe_unused]] const named_argument<Tag, ExplicitType> &narg)
 {
-    return (... || detail::is_tagged_container<Tag, detail::uncvref_t<Args>>::value);
+    using tag_set_t = detail::tag_set<Args...>;
+
+    return detail::contains_tag_id(detail::sorted_tag_entries<Args...>, tag_set_t::template lookup_id<Tag>());
 }
 
 template <typename... Args, typename... Tags, typename... ExplicitTypes>
-constexpr bool has_all(const named_argument<Tags, ExplicitTypes> &... nargs)
+constexpr bool has_all([[maybe_unused]] const named_argument<Tags, ExplicitTypes> &... nargs)
 {
-    return (... && ::igor::has<Args...>(nargs));
+    using tag_set_t = detail::tag_set<Args...>;
+
+    // NOTE: look up the tag IDs directly rather than going through
+    // has(), in order to avoid one function instantiation per tag.
+    return (... && detail::contains_tag_id(detail::sorted_tag_entries<Args...>, tag_set_t::template lookup_id<Tags>()));
 }
 
 template <typename... Args, typename... Tags, typename... ExplicitTypes>
-constexpr bool has_any(const named_argument<Tags, ExplicitTypes> &... nargs)
+constexpr bool has_any([[maybe_unused]] const named_argument<Tags, ExplicitTypes> &... nargs)
 {
-    return (... || ::igor::has<Args...>(nargs));
+    using tag_set_t = detail::tag_set<Args...>;
+
+    return (... || detail::contains_tag_id(detail::sorted_tag_entries<Args...>, tag_set_t::template lookup_id<Tags>()));
 }
 
 template <typename... Args>
@@ -201,82 +733,721 @@ constexpr bool has_unnamed_arguments()
 }
 
 template <typename... Args, typename... Tags, typename... ExplicitTypes>
-constexpr bool has_other_than(const named_argument<Tags, ExplicitTypes> &... nargs)
+constexpr bool has_other_than([[maybe_unused]] const named_argument<Tags, ExplicitTypes> &... nargs)
 {
-    // NOTE: the first fold expression will return how many of the nargs
-    // are in the pack. The second fold expression will return the total number
+    using tag_set_t = detail::tag_set<Args...>;
+
+    // NOTE: the fold expression will return how many of the nargs
+    // are in the pack, which we then compare to the total number
     // of named arguments in the pack.
-    return (::std::size_t(0) + ... + static_cast<::std::size_t>(::igor::has<Args...>(nargs)))
-           < (::std::size_t(0) + ...
-              + static_cast<::std::size_t>(detail::is_tagged_container_any<detail::uncvref_t<Args>>::value));
+    return (::std::size_t(0) + ...
+            + static_cast<::std::size_t>(
+                detail::contains_tag_id(detail::sorted_tag_entries<Args...>, tag_set_t::template lookup_id<Tags>())))
+           < detail::n_named_arguments<Args...>;
 }
 
 namespace detail
 {
 
-// Check if T is a named argument which appears more than once in Args.
-template <typename T, typename... Args>
-constexpr bool is_repeated_named_argument()
+// Position in Args of the first occurrence of the first tag (in call order)
+// which appears more than once among the named arguments of Args. If there
+// are no duplicate tags, sizeof...(Args) will be returned.
+// NOTE: duplicate tags are adjacent in the sorted list of tag entries,
+// and, within a run of equal tags, the first entry is the first
+// occurrence in call order (because the sort is stable).
+template <typename... Args>
+constexpr ::std::size_t first_duplicate_index()
+{
+    constexpr auto &entries = sorted_tag_entries<Args...>;
+
+    ::std::size_t retval = sizeof...(Args);
+
+    for (::std::size_t i = 0; i + 1u < n_named_arguments<Args...>;) {
+        auto j = i + 1u;
+        while (j < n_named_arguments<Args...> && entries[j].id == entries[i].id) {
+            ++j;
+        }
+
+        if (j - i > 1u && entries[i].index < retval) {
+            retval = entries[i].index;
+        }
+
+        i = j;
+    }
+
+    return retval;
+}
+
+template <typename T>
+struct type_wrapper {
+    using type = T;
+};
+
+template <typename... Args>
+constexpr auto first_duplicate_impl()
+{
+    constexpr auto idx = detail::first_duplicate_index<Args...>();
+
+    if constexpr (idx == sizeof...(Args)) {
+        return type_wrapper<void>{};
+    } else {
+        return type_wrapper<typename uncvref_t<type_at_t<idx, Args...>>::tag_type>{};
+    }
+}
+
+// Positions of the named arguments in Args.
+template <typename... Args>
+constexpr auto make_named_positions()
+{
+    constexpr ct_array<bool, sizeof...(Args)> named{{is_tagged_container_any<uncvref_t<Args>>::value...}};
+
+    ct_array<::std::size_t, n_named_arguments<Args...>> retval{};
+    for (::std::size_t i = 0, j = 0; i < sizeof...(Args); ++i) {
+        if (named[i]) {
+            retval[j++] = i;
+        }
+    }
+
+    return retval;
+}
+
+template <typename... Args>
+inline constexpr auto named_positions = make_named_positions<Args...>();
+
+// Positions of the unnamed arguments in Args.
+template <typename... Args>
+constexpr auto make_unnamed_positions()
+{
+    constexpr ct_array<bool, sizeof...(Args)> named{{is_tagged_container_any<uncvref_t<Args>>::value...}};
+
+    ct_array<::std::size_t, sizeof...(Args) - n_named_arguments<Args...>> retval{};
+    for (::std::size_t i = 0, j = 0; i < sizeof...(Args); ++i) {
+        if (!named[i]) {
+            retval[j++] = i;
+        }
+    }
+
+    return retval;
+}
+
+template <typename... Args>
+inline constexpr auto unnamed_positions = make_unnamed_positions<Args...>();
+
+// Number of true values in a.
+template <::std::size_t N>
+constexpr ::std::size_t count_true(const ct_array<bool, N> &a)
+{
+    ::std::size_t retval = 0;
+    for (::std::size_t i = 0; i < N; ++i) {
+        retval += static_cast<::std::size_t>(a[i]);
+    }
+    return retval;
+}
+
+// Position in the parser's storage of the I-th argument in Args
+// (the named arguments come first, followed by the unnamed ones).
+template <::std::size_t I, typename... Args>
+constexpr ::std::size_t storage_slot()
+{
+    constexpr ct_array<bool, sizeof...(Args)> named{{is_tagged_container_any<uncvref_t<Args>>::value...}};
+
+    ::std::size_t n_named_before = 0;
+    for (::std::size_t i = 0; i < I; ++i) {
+        n_named_before += static_cast<::std::size_t>(named[i]);
+    }
+
+    return named[I] ? n_named_before : n_named_arguments<Args...> + (I - n_named_before);
+}
+
+// Type of the reference to the unnamed argument of type T returned by
+// the parser: if T is a reference, T itself (for perfect forwarding),
+// otherwise a const lvalue reference.
+template <typename T>
+using unnamed_ref_t = ::std::conditional_t<::std::is_reference_v<T>, T, const T &>;
+
+// Type of the value stored in the tagged container T
+// (a reference of some kind, or a value type for
+// explicitly-typed named arguments).
+template <typename T>
+using tagged_value_t = decltype(uncvref_t<T>::value);
+
+// Type used to store an element of type T in ref_tuple:
+// references are stored as pointers, values as they are.
+template <typename T>
+using storage_elem_t = ::std::conditional_t<::std::is_reference_v<T>, ::std::remove_reference_t<T> *, T>;
+
+// Check if values of type T in tagged containers are copied
+// into the parser: this is the case for small trivially copyable
+// value types (e.g., flags and tolerances), for which a copy is cheap.
+template <typename T>
+inline constexpr bool parser_copies_v
+    = !::std::is_reference_v<T> && ::std::is_trivially_copyable_v<T> && sizeof(T) <= 2u * sizeof(void *);
+
+// Type used to store the value of type T of a named argument in
+// the parser: a copy of the value (see parser_copies_v), or a pointer
+// to the value (which, for value types, lives in the tagged container).
+template <typename T>
+using parser_elem_t = ::std::conditional_t<parser_copies_v<T>, T, ::std::remove_reference_t<unnamed_ref_t<T>> *>;
+
+// Element of the parser's storage for the value in the tagged
+// container x.
+// NOTE: use the builtin rather than std::addressof() to avoid
+// pulling in <memory>. The builtin is available on all the major
+// compilers.
+template <typename T>
+IGOR_FORCE_INLINE constexpr parser_elem_t<tagged_value_t<T>> tagged_value_elem(const T &x)
 {
-    if constexpr (is_tagged_container_any<uncvref_t<T>>::value) {
-        return (::std::size_t(0) + ... + static_cast<::std::size_t>(::std::is_same_v<uncvref_t<T>, uncvref_t<Args>>))
-               > 1u;
+    if constexpr (parser_copies_v<tagged_value_t<T>>) {
+        return x.value;
     } else {
-        return false;
+        return __builtin_addressof(x.value);
     }
 }
 
+// Flat aggregate storage for values of types Ts, used in place
+// of std::tuple to avoid the cost of including <tuple>.
+// The values are stored in leaves indexed by their
+// position, so that they can be fetched without recursion.
+template <::std::size_t I, typename T>
+struct storage_leaf {
+    T value;
+};
+
+template <typename, typename...>
+struct flat_storage;
+
+template <::std::size_t... Is, typename... Ts>
+struct flat_storage<::std::index_sequence<Is...>, Ts...> : storage_leaf<Is, Ts>... {
+};
+
+template <typename... Ts>
+using flat_storage_t = flat_storage<::std::index_sequence_for<Ts...>, Ts...>;
+
+// Fetch the I-th value in a flat storage.
+template <::std::size_t I, typename T>
+IGOR_FORCE_INLINE constexpr const T &storage_get(const storage_leaf<I, T> &l)
+{
+    return l.value;
+}
+
+// Implementation of parsers' constructor.
+// This function will take a set of input arguments
+// (as const ref, unless Args are references) and will filter out the named
+// arguments, returning a flat storage of pointers to the values associated to
+// them, followed by the pointers to the unnamed arguments.
+// NOTE: the addresses of all the arguments are first collected in
+// a flat storage, from which the named arguments are then picked
+// via the list of their positions. This avoids both intermediate
+// tuples and per-argument function calls with the full pack as
+// arguments (which would result in a quadratic amount of code).
+// Storing the addresses of the values (rather than references
+// to the tagged containers) means that fetching a value requires
+// a single indirection. The values of named arguments explicitly
+// typed with trivially copyable value types are copied into
+// the storage instead.
+template <typename... Args, ::std::size_t... Is, ::std::size_t... Js, typename Ptrs>
+IGOR_FORCE_INLINE constexpr auto build_parser_storage_impl(::std::index_sequence<Is...>, ::std::index_sequence<Js...>,
+                                                           const Ptrs &ptrs)
+{
+    return flat_storage_t<parser_elem_t<tagged_value_t<type_at_t<named_positions<Args...>[Is], Args...>>>...,
+                          ::std::remove_reference_t<const type_at_t<unnamed_positions<Args...>[Js], Args...> &> *...>{
+        {detail::tagged_value_elem(*detail::storage_get<named_positions<Args...>[Is]>(ptrs))}...,
+        {detail::storage_get<unnamed_positions<Args...>[Js]>(ptrs)}...};
+}
+
+// NOTE: Args must be specified explicitly, so that
+// reference types are preserved.
+template <typename... Args>
+IGOR_FORCE_INLINE constexpr auto build_parser_storage(const Args &... args)
+{
+    return detail::build_parser_storage_impl<Args...>(
+        ::std::make_index_sequence<n_named_arguments<Args...>>{},
+        ::std::make_index_sequence<sizeof...(Args) - n_named_arguments<Args...>>{},
+        flat_storage_t<::std::remove_reference_t<const Args &> *...>{{__builtin_addressof(args)}...});
+}
+
+// Detect if T has a static value member, usable in constant expressions.
+template <typename T, typename = void>
+struct has_static_value : ::std::false_type {
+};
+
+template <typename T>
+struct has_static_value<T, ::std::void_t<::std::integral_constant<bool, (static_cast<void>(T::value), true)>>>
+    : ::std::true_type {
+};
+
+// Tuple-like class holding the references Ts (as pointers).
+// This is the return type of parser's call operator when
+// multiple named arguments are fetched, and it supports
+// structured bindings. Ts may also contain non-reference types
+// (i.e., the results of lazy values), which are stored by value.
+template <typename... Ts>
+class ref_tuple
+{
+    template <::std::size_t I>
+    using leaf_t = storage_leaf<I, storage_elem_t<type_at_t<I, Ts...>>>;
+
+    template <typename T>
+    IGOR_FORCE_INLINE static constexpr storage_elem_t<T> make_elem(T &&x)
+    {
+        if constexpr (::std::is_reference_v<T>) {
+            return __builtin_addressof(x);
+        } else {
+            return static_cast<T &&>(x);
+        }
+    }
+
+    // NOTE: elements stored by value are returned with
+    // the constness and the value category of self.
+    template <::std::size_t I, typename Self>
+    IGOR_FORCE_INLINE static constexpr decltype(auto) get_impl(Self &&self)
+    {
+        using T = type_at_t<I, Ts...>;
+
+        if constexpr (::std::is_reference_v<T>) {
+            return static_cast<T>(*static_cast<const leaf_t<I> &>(self.m_elems).value);
+        } else {
+            using leaf_cv_t = ::std::conditional_t<::std::is_const_v<::std::remove_reference_t<Self>>,
+                                                   const leaf_t<I>, leaf_t<I>>;
+            using leaf_ref_t
+                = ::std::conditional_t<::std::is_lvalue_reference_v<Self>, leaf_cv_t &, leaf_cv_t &&>;
+
+            return (static_cast<leaf_ref_t>(self.m_elems).value);
+        }
+    }
+
+public:
+    IGOR_FORCE_INLINE constexpr explicit ref_tuple(Ts... xs)
+        : m_elems{{ref_tuple::make_elem<Ts>(static_cast<Ts &&>(xs))}...}
+    {
+    }
+
+    template <::std::size_t I>
+    IGOR_FORCE_INLINE constexpr decltype(auto) get() &
+    {
+        return ref_tuple::get_impl<I>(*this);
+    }
+    template <::std::size_t I>
+    IGOR_FORCE_INLINE constexpr decltype(auto) get() const &
+    {
+        return ref_tuple::get_impl<I>(*this);
+    }
+    template <::std::size_t I>
+    IGOR_FORCE_INLINE constexpr decltype(auto) get() &&
+    {
+        return ref_tuple::get_impl<I>(static_cast<ref_tuple &&>(*this));
+    }
+    template <::std::size_t I>
+    IGOR_FORCE_INLINE constexpr decltype(auto) get() const &&
+    {
+        return ref_tuple::get_impl<I>(static_cast<const ref_tuple &&>(*this));
+    }
+
+private:
+    flat_storage_t<storage_elem_t<Ts>...> m_elems;
+};
+
+// Address of the referenced object x.
+template <typename T>
+IGOR_FORCE_INLINE constexpr auto ref_address(T &&x)
+{
+    return __builtin_addressof(x);
+}
+
+// Array-like class holding N references of type T (as pointers).
+// This is the return type of parser::all() when all the occurrences
+// of a named argument have the same type. It supports range-based
+// for loops and structured bindings.
+template <typename T, ::std::size_t N>
+class ref_array
+{
+    static_assert(::std::is_reference_v<T>, "ref_array can hold only references.");
+
+    using ptr_t = ::std::remove_reference_t<T> *;
+
+public:
+    // Minimal iterator, yielding the references.
+    class iterator
+    {
+    public:
+        IGOR_FORCE_INLINE constexpr explicit iterator(const ptr_t *ptr) : m_ptr(ptr) {}
+
+        IGOR_FORCE_INLINE constexpr T operator*() const
+        {
+            return static_cast<T>(**m_ptr);
+        }
+        IGOR_FORCE_INLINE constexpr iterator &operator++()
+        {
+            ++m_ptr;
+            return *this;
+        }
+        IGOR_FORCE_INLINE constexpr iterator operator++(int)
+        {
+            auto retval = *this;
+            ++m_ptr;
+            return retval;
+        }
+        friend constexpr bool operator==(const iterator &a, const iterator &b)
+        {
+            return a.m_ptr == b.m_ptr;
+        }
+        friend constexpr bool operator!=(const iterator &a, const iterator &b)
+        {
+            return a.m_ptr != b.m_ptr;
+        }
+
+    private:
+        const ptr_t *m_ptr;
+    };
+
+    IGOR_FORCE_INLINE constexpr explicit ref_array(const ct_array<ptr_t, N> &ptrs) : m_ptrs(ptrs) {}
+
+    static constexpr ::std::size_t size()
+    {
+        return N;
+    }
+    IGOR_FORCE_INLINE constexpr T operator[](::std::size_t i) const
+    {
+        return static_cast<T>(*m_ptrs[i]);
+    }
+    template <::std::size_t I>
+    IGOR_FORCE_INLINE constexpr T get() const
+    {
+        static_assert(I < N, "Out of range ref_array access.");
+        return static_cast<T>(*m_ptrs[I]);
+    }
+    IGOR_FORCE_INLINE constexpr iterator begin() const
+    {
+        return iterator(m_ptrs.data);
+    }
+    IGOR_FORCE_INLINE constexpr iterator end() const
+    {
+        return iterator(m_ptrs.data + N);
+    }
+
+private:
+    ct_array<ptr_t, N> m_ptrs;
+};
+
 } // namespace detail
 
+// Check if Args contains duplicate named arguments (that is, check
+// if at least one tag appears more than once, regardless of the types
+// of the values associated to it).
 template <typename... Args>
 constexpr bool has_duplicates()
 {
-    return (... || detail::is_repeated_named_argument<Args, Args...>());
+    return detail::first_duplicate_index<Args...>() != sizeof...(Args);
 }
 
+// The first tag, in call order, which appears more than once in
+// the named arguments of Args. If there are no duplicates, this will
+// be void.
+template <typename... Args>
+using first_duplicate_t = typename decltype(detail::first_duplicate_impl<Args...>())::type;
+
 // Parser for named arguments in a function call.
+// NOTE: when constructing a parser via CTAD (parser p{args...}),
+// ParseArgs are deduced as non-reference types. The arguments
+// can also be parsed as parser<Args &&...> p{args...}, so that
+// the unnamed arguments can be perfectly forwarded.
 template <typename... ParseArgs>
 class parser
 {
-    using tuple_t = decltype(detail::build_parser_tuple(::std::declval<const ParseArgs &>()...));
+    using storage_t = decltype(detail::build_parser_storage<ParseArgs...>(::std::declval<const ParseArgs &>()...));
+    // NOTE: alias the tag set once here, rather than spelling it out
+    // over the whole pack in every lookup.
+    using tag_set_t = detail::tag_set<ParseArgs...>;
 
 public:
-    constexpr explicit parser(const ParseArgs &... parse_args) : m_nargs(detail::build_parser_tuple(parse_args...)) {}
+    IGOR_FORCE_INLINE constexpr explicit parser(const ParseArgs &... parse_args)
+        : m_nargs(detail::build_parser_storage<ParseArgs...>(parse_args...))
+    {
+    }
 
 private:
     // Fetch the value associated to the input named
     // argument narg. If narg is not present, this will
     // return a const ref to a global not_provided_t object.
-    template <::std::size_t I, typename Tag, typename ExplicitType>
-    constexpr decltype(auto) fetch_one_impl([[maybe_unused]] const named_argument<Tag, ExplicitType> &narg) const
+    // NOTE: the position of narg in m_nargs is looked up at compile
+    // time in the slot map, thus no recursion over m_nargs is needed.
+    template <typename Tag, typename ExplicitType>
+    IGOR_FORCE_INLINE constexpr decltype(auto)
+    fetch_one([[maybe_unused]] const named_argument<Tag, ExplicitType> &narg) const
     {
-        if constexpr (I == ::std::tuple_size_v<tuple_t>) {
+        constexpr auto slot = detail::find_slot<ParseArgs...>(tag_set_t::template lookup_id<Tag>());
+
+        if constexpr (slot == detail::n_named_arguments<ParseArgs...>) {
             return static_cast<const not_provided_t &>(not_provided);
-        } else if constexpr (::std::is_same_v<typename detail::uncvref_t<::std::tuple_element_t<I, tuple_t>>::tag_type,
-                                              Tag>) {
-            if constexpr (::std::is_rvalue_reference_v<decltype(::std::get<I>(m_nargs).value)>) {
-                return ::std::move(::std::get<I>(m_nargs).value);
-            } else {
-                return ::std::get<I>(m_nargs).value;
+        } else {
+            return this->template fetch_slot<slot>();
+        }
+    }
+    // Fetch the value of the named argument in
+    // the position Slot of the parser's storage.
+    template <::std::size_t Slot>
+    IGOR_FORCE_INLINE constexpr decltype(auto) fetch_slot() const
+    {
+        using value_t
+            = detail::tagged_value_t<detail::type_at_t<detail::named_positions<ParseArgs...>[Slot], ParseArgs...>>;
+
+        if constexpr (detail::parser_copies_v<value_t>) {
+            // NOTE: values copied into the parser
+            // are returned as const references.
+            return detail::storage_get<Slot>(m_nargs);
+        } else if constexpr (!::std::is_reference_v<value_t>) {
+            // NOTE: values stored by value in the tagged
+            // container are returned as const references.
+            return static_cast<const value_t &>(*detail::storage_get<Slot>(m_nargs));
+        } else if constexpr (detail::is_lazy_value<detail::uncvref_t<value_t>>::value) {
+            // NOTE: lazy values are evaluated here, on fetch.
+            return (*detail::storage_get<Slot>(m_nargs))();
+        } else {
+            // NOTE: the cast restores the original value category.
+            return static_cast<value_t>(*detail::storage_get<Slot>(m_nargs));
+        }
+    }
+    // Re-tag the named argument in the position Slot of the parser's
+    // storage, without fetching its value (thus lazy values are not
+    // evaluated). Values stored by value (in the parser or in the
+    // tagged container) are referred to via const lvalue references.
+    template <::std::size_t Slot>
+    IGOR_FORCE_INLINE constexpr auto retag_slot() const
+    {
+        using arg_t = detail::uncvref_t<detail::type_at_t<detail::named_positions<ParseArgs...>[Slot], ParseArgs...>>;
+        using value_t = detail::tagged_value_t<arg_t>;
+
+        if constexpr (::std::is_reference_v<value_t>) {
+            return detail::tagged_container<typename arg_t::tag_type, value_t>{
+                static_cast<value_t>(*detail::storage_get<Slot>(m_nargs))};
+        } else {
+            return detail::tagged_container<typename arg_t::tag_type, const value_t &>{
+                this->template fetch_slot<Slot>()};
+        }
+    }
+    // The I-th argument of the parser as it would be passed
+    // to a function: a re-tagged named argument, or a
+    // reference to an unnamed argument.
+    template <::std::size_t I>
+    IGOR_FORCE_INLINE constexpr decltype(auto) view_arg() const
+    {
+        constexpr auto slot = detail::storage_slot<I, ParseArgs...>();
+
+        if constexpr (slot < detail::n_named_arguments<ParseArgs...>) {
+            return this->template retag_slot<slot>();
+        } else {
+            return this->template unnamed<slot - detail::n_named_arguments<ParseArgs...>>();
+        }
+    }
+    // Slots of the named arguments with tags Tags
+    // which are present in the parser, in the order of Tags.
+    template <typename... Tags>
+    static constexpr auto make_forward_slots()
+    {
+        constexpr detail::ct_array<::std::size_t, sizeof...(Tags)> slots{
+            {detail::find_slot<ParseArgs...>(tag_set_t::template lookup_id<Tags>())...}};
+        constexpr auto n_present
+            = (::std::size_t(0) + ...
+               + static_cast<::std::size_t>(detail::find_slot<ParseArgs...>(tag_set_t::template lookup_id<Tags>())
+                                            != detail::n_named_arguments<ParseArgs...>));
+
+        detail::ct_array<::std::size_t, n_present> retval{};
+        for (::std::size_t i = 0, j = 0; i < sizeof...(Tags); ++i) {
+            if (slots[i] != detail::n_named_arguments<ParseArgs...>) {
+                retval[j++] = slots[i];
             }
+        }
+
+        return retval;
+    }
+    template <typename... Tags>
+    static constexpr auto forward_slots = make_forward_slots<Tags...>();
+    template <typename... Tags, typename F, ::std::size_t... Is>
+    IGOR_FORCE_INLINE constexpr decltype(auto) forward_impl(::std::index_sequence<Is...>, F &&f) const
+    {
+        return static_cast<F &&>(f)(this->template retag_slot<forward_slots<Tags...>[Is]>()...);
+    }
+    // Flags signalling which arguments in ParseArgs
+    // are not named arguments with tags Tags.
+    template <typename... Tags>
+    static constexpr auto make_without_keep()
+    {
+        constexpr detail::ct_array<tag_id_t, sizeof...(ParseArgs)> ids{
+            {detail::arg_tag_id<detail::uncvref_t<ParseArgs>>()...}};
+        constexpr detail::ct_array<bool, sizeof...(ParseArgs)> named{
+            {detail::is_tagged_container_any<detail::uncvref_t<ParseArgs>>::value...}};
+        constexpr detail::ct_array<tag_id_t, sizeof...(Tags)> excluded{{tag_set_t::template lookup_id<Tags>()...}};
+
+        detail::ct_array<bool, sizeof...(ParseArgs)> keep{};
+        for (::std::size_t i = 0; i < sizeof...(ParseArgs); ++i) {
+            keep[i] = true;
+            for (::std::size_t j = 0; named[i] && j < sizeof...(Tags); ++j) {
+                keep[i] = keep[i] && ids[i] != excluded[j];
+            }
+        }
+
+        return keep;
+    }
+    // Positions of the arguments in ParseArgs which
+    // are not named arguments with tags Tags.
+    template <typename... Tags>
+    static constexpr auto make_without_positions()
+    {
+        constexpr auto keep = make_without_keep<Tags...>();
+
+        detail::ct_array<::std::size_t, detail::count_true(keep)> retval{};
+        for (::std::size_t i = 0, j = 0; i < sizeof...(ParseArgs); ++i) {
+            if (keep[i]) {
+                retval[j++] = i;
+            }
+        }
+
+        return retval;
+    }
+    template <typename... Tags>
+    static constexpr auto without_positions = make_without_positions<Tags...>();
+    template <typename... Tags, ::std::size_t... Is>
+    IGOR_FORCE_INLINE constexpr auto without_impl(::std::index_sequence<Is...>) const
+    {
+        return ::igor::parser<decltype(this->template view_arg<without_positions<Tags...>[Is]>())...>(
+            this->template view_arg<without_positions<Tags...>[Is]>()...);
+    }
+    template <::std::size_t... Is>
+    IGOR_FORCE_INLINE constexpr auto unnamed_impl(::std::index_sequence<Is...>) const
+    {
+        return detail::ref_tuple<decltype(this->template unnamed<Is>())...>(this->template unnamed<Is>()...);
+    }
+    template <typename Tag, ::std::size_t... Is>
+    IGOR_FORCE_INLINE constexpr auto all_impl(::std::index_sequence<Is...>) const
+    {
+        if constexpr (sizeof...(Is) == 0u) {
+            return detail::ref_array<const not_provided_t &, 0>(detail::ct_array<const not_provided_t *, 0>{});
         } else {
-            return fetch_one_impl<I + 1u>(narg);
+            using first_t = decltype(this->template fetch_slot<detail::tag_slots<Tag, ParseArgs...>[0]>());
+
+            if constexpr (::std::is_reference_v<first_t>
+                          && (... && detail::is_same_v<decltype(this->template fetch_slot<
+                                                                 detail::tag_slots<Tag, ParseArgs...>[Is]>()),
+                                                       first_t>)) {
+                return detail::ref_array<first_t, sizeof...(Is)>(
+                    detail::ct_array<::std::remove_reference_t<first_t> *, sizeof...(Is)>{{detail::ref_address(
+                        this->template fetch_slot<detail::tag_slots<Tag, ParseArgs...>[Is]>())...}});
+            } else if constexpr ((... && ::std::is_reference_v<decltype(this->template fetch_slot<
+                                                                     detail::tag_slots<Tag, ParseArgs...>[Is]>())>)
+                                 && (... && detail::is_same_v<detail::uncvref_t<decltype(this->template fetch_slot<
+                                                                  detail::tag_slots<Tag, ParseArgs...>[Is]>())>,
+                                                              detail::uncvref_t<first_t>>)) {
+                // NOTE: references of different kinds to values of the same
+                // type (e.g., f(arg = x, arg = 5)) are all viewed as const
+                // lvalue references, so that the result can be iterated over.
+                using value_t = const detail::uncvref_t<first_t>;
+
+                return detail::ref_array<value_t &, sizeof...(Is)>(detail::ct_array<value_t *, sizeof...(Is)>{
+                    {detail::ref_address(this->template fetch_slot<detail::tag_slots<Tag, ParseArgs...>[Is]>())...}});
+            } else {
+                return detail::ref_tuple<decltype(this->template fetch_slot<
+                                                  detail::tag_slots<Tag, ParseArgs...>[Is]>())...>(
+                    this->template fetch_slot<detail::tag_slots<Tag, ParseArgs...>[Is]>()...);
+            }
         }
     }
 
 public:
     // Get references to the values associated to the input named arguments.
     template <typename... Tags, typename... ExplicitTypes>
-    constexpr decltype(auto) operator()([[maybe_unused]] const named_argument<Tags, ExplicitTypes> &... nargs) const
+    IGOR_FORCE_INLINE constexpr decltype(auto)
+    operator()([[maybe_unused]] const named_argument<Tags, ExplicitTypes> &... nargs) const
     {
         if constexpr (sizeof...(Tags) == 0u) {
             return;
         } else if constexpr (sizeof...(Tags) == 1u) {
-            return this->fetch_one_impl<0>(nargs...);
+            return this->fetch_one(nargs...);
+        } else {
+            return detail::ref_tuple<decltype(this->fetch_one(nargs))...>(this->fetch_one(nargs)...);
+        }
+    }
+    // Get references to the values associated to all the occurrences
+    // of the input named argument narg, in call order. If all the
+    // occurrences have the same type, or are references to values of the
+    // same type (which are then returned as const lvalue references), the
+    // return value is an array-like object which can be iterated over,
+    // otherwise it is a tuple-like object.
+    // In both cases, structured bindings are supported.
+    template <typename Tag, typename ExplicitType>
+    IGOR_FORCE_INLINE constexpr auto all(const named_argument<Tag, ExplicitType> &) const
+    {
+        return this->template all_impl<Tag>(
+            ::std::make_index_sequence<detail::tag_slots<Tag, ParseArgs...>.size()>{});
+    }
+    // Get a reference to the I-th unnamed argument. If ParseArgs are
+    // references, the original value category is restored, otherwise
+    // a const lvalue reference is returned.
+    template <::std::size_t I>
+    IGOR_FORCE_INLINE constexpr detail::unnamed_ref_t<
+        detail::type_at_t<detail::unnamed_positions<ParseArgs...>[I], ParseArgs...>>
+    unnamed() const
+    {
+        return static_cast<
+            detail::unnamed_ref_t<detail::type_at_t<detail::unnamed_positions<ParseArgs...>[I], ParseArgs...>>>(
+            *detail::storage_get<detail::n_named_arguments<ParseArgs...> + I>(m_nargs));
+    }
+    // Get references to all the unnamed arguments, in call order.
+    IGOR_FORCE_INLINE constexpr auto unnamed() const
+    {
+        return this->unnamed_impl(
+            ::std::make_index_sequence<sizeof...(ParseArgs) - detail::n_named_arguments<ParseArgs...>>{});
+    }
+    // Invoke f with the named arguments nargs which are present in the
+    // parser (in the order of nargs), re-tagged so that they refer to the
+    // original values. No values are copied, and lazy values are forwarded
+    // without being evaluated.
+    template <typename F, typename... Tags, typename... ExplicitTypes>
+    IGOR_FORCE_INLINE constexpr decltype(auto) forward(F &&f, const named_argument<Tags, ExplicitTypes> &...) const
+    {
+        return this->template forward_impl<Tags...>(
+            ::std::make_index_sequence<forward_slots<Tags...>.size()>{}, static_cast<F &&>(f));
+    }
+    // Create a parser over the arguments of this parser, excluding
+    // all the occurrences of the named arguments nargs. The new parser
+    // refers to the original values, thus it must not outlive them.
+    template <typename... Tags, typename... ExplicitTypes>
+    IGOR_FORCE_INLINE constexpr auto without(const named_argument<Tags, ExplicitTypes> &...) const
+    {
+        return this->template without_impl<Tags...>(
+            ::std::make_index_sequence<without_positions<Tags...>.size()>{});
+    }
+    // Fetch the value associated to the input named argument narg
+    // if present, otherwise return the result of invoking f. f is invoked
+    // (and its call operator instantiated) only if narg is missing.
+    template <typename Tag, typename ExplicitType, typename F>
+    IGOR_FORCE_INLINE constexpr decltype(auto) get_or(const named_argument<Tag, ExplicitType> &narg, F &&f) const
+    {
+        if constexpr (detail::find_slot<ParseArgs...>(tag_set_t::template lookup_id<Tag>())
+                      == detail::n_named_arguments<ParseArgs...>) {
+            return static_cast<F &&>(f)();
         } else {
-            return ::std::forward_as_tuple(this->fetch_one_impl<0>(nargs)...);
+            return this->fetch_one(narg);
         }
     }
+    // Fetch, as a constant expression, the value associated to the input
+    // named argument narg, which must be a compile-time value (that is,
+    // ct<V> or any other object with a static constexpr value member,
+    // such as a std::integral_constant).
+    template <typename Tag, typename ExplicitType>
+    static constexpr auto constant(const named_argument<Tag, ExplicitType> &)
+    {
+        static_assert(detail::find_slot<ParseArgs...>(tag_set_t::template lookup_id<Tag>())
+                          != detail::n_named_arguments<ParseArgs...>,
+                      "A named argument must be present in order to be fetched as a constant.");
+
+        using value_t = detail::uncvref_t<decltype(::std::declval<const parser &>().fetch_one(
+            ::std::declval<const named_argument<Tag, ExplicitType> &>()))>;
+
+        static_assert(detail::has_static_value<value_t>::value,
+                      "A named argument can be fetched as a constant only if its value is a compile-time value.");
+
+        return value_t::value;
+    }
     // Check if the input named argument na is present in the parser.
     template <typename Tag, typename ExplicitType>
     static constexpr bool has(const named_argument<Tag, ExplicitType> &narg)
@@ -314,11 +1485,133 @@ public:
     }
 
 private:
-    tuple_t m_nargs;
+    storage_t m_nargs;
+};
+
+namespace detail
+{
+
+// Canonical order of the arguments Args: the unnamed arguments keep their
+// positions, while the named arguments are permuted among themselves
+// so that they are sorted by tag ID. The returned array contains, for each
+// position in the canonical order, the position of the argument in Args.
+template <typename... Args>
+constexpr auto make_canonical_order()
+{
+    constexpr ct_array<bool, sizeof...(Args)> named{{is_tagged_container_any<uncvref_t<Args>>::value...}};
+
+    ct_array<::std::size_t, sizeof...(Args)> retval{};
+    for (::std::size_t i = 0, j = 0; i < sizeof...(Args); ++i) {
+        retval[i] = named[i] ? sorted_tag_entries<Args...>[j++].index : i;
+    }
+
+    return retval;
+}
+
+template <typename... Args>
+inline constexpr auto canonical_order = make_canonical_order<Args...>();
+
+template <typename... Args, ::std::size_t... Is, typename F, typename Ptrs>
+constexpr decltype(auto) canonicalize_impl(::std::index_sequence<Is...>, F &&f, const Ptrs &ptrs)
+{
+    return static_cast<F &&>(f)(static_cast<type_at_t<canonical_order<Args...>[Is], Args...> &&>(
+        *detail::storage_get<canonical_order<Args...>[Is]>(ptrs))...);
+}
+
+} // namespace detail
+
+// Invoke f with the arguments args, after having sorted the named arguments
+// in a canonical order (the unnamed arguments keep their positions). All
+// the call-site orderings of the same set of named arguments thus result
+// in the same instantiation of f.
+template <typename F, typename... Args>
+constexpr decltype(auto) canonicalize(F &&f, Args &&... args)
+{
+    return detail::canonicalize_impl<Args...>(
+        ::std::index_sequence_for<Args...>{}, static_cast<F &&>(f),
+        detail::flat_storage_t<::std::remove_reference_t<Args> *...>{{__builtin_addressof(args)}...});
+}
+
+// Field of a signature: the named argument NArg is stored
+// in the data member MemPtr of the signature's aggregate.
+template <const auto &NArg, auto MemPtr>
+struct field {
+};
+
+// Signature of a function accepting the named arguments listed in
+// Fields. The named arguments passed to a function can be lowered via
+// lower() into the aggregate S, whose data members provide the types
+// and the default values of the named arguments. This allows to implement
+// the function as a single non-template function taking an S, with a
+// thin variadic front-end calling lower().
+template <typename S, typename... Fields>
+struct signature;
+
+template <typename S, const auto &... NArgs, auto... MemPtrs>
+struct signature<S, field<NArgs, MemPtrs>...> {
+    // Check if a call with the arguments Args can be lowered:
+    // only named arguments appearing in the signature are accepted,
+    // and each at most once.
+    template <typename... Args>
+    static constexpr bool accepts = !::igor::has_unnamed_arguments<Args...>()
+                                    && !::igor::has_other_than<Args...>(NArgs...)
+                                    && !::igor::has_duplicates<Args...>();
+
+    template <typename... Args>
+    static constexpr S lower(Args &&... args)
+    {
+        static_assert(!::igor::has_unnamed_arguments<Args...>(), "Unnamed arguments cannot be lowered to a signature.");
+        static_assert(!::igor::has_other_than<Args...>(NArgs...),
+                      "Named arguments not appearing in the signature were passed.");
+        static_assert(!::igor::has_duplicates<Args...>(), "Duplicate named arguments were passed.");
+
+        parser p{args...};
+
+        // NOTE: the data members of S corresponding to missing
+        // named arguments will keep their default values.
+        S retval{};
+        (signature::assign<NArgs, MemPtrs>(retval, p), ...);
+
+        return retval;
+    }
+
+private:
+    template <const auto &NArg, auto MemPtr, typename P>
+    static constexpr void assign([[maybe_unused]] S &retval, [[maybe_unused]] const P &p)
+    {
+        if constexpr (P::has(NArg)) {
+            retval.*MemPtr = p(NArg);
+        }
+    }
 };
 
 } // namespace igor
 
+// Tuple-like protocol for ref_tuple and ref_array, for use in structured bindings.
+// NOTE: std::tuple_size and std::tuple_element are declared in <utility>.
+namespace std
+{
+
+template <typename... Ts>
+struct tuple_size<::igor::detail::ref_tuple<Ts...>> : ::std::integral_constant<::std::size_t, sizeof...(Ts)> {
+};
+
+template <::std::size_t I, typename... Ts>
+struct tuple_element<I, ::igor::detail::ref_tuple<Ts...>> {
+    using type = ::igor::detail::type_at_t<I, Ts...>;
+};
+
+template <typename T, ::std::size_t N>
+struct tuple_size<::igor::detail::ref_array<T, N>> : ::std::integral_constant<::std::size_t, N> {
+};
+
+template <::std::size_t I, typename T, ::std::size_t N>
+struct tuple_element<I, ::igor::detail::ref_array<T, N>> {
+    using type = T;
+};
+
+} // namespace std
+
 // Handy macro (ew) for the definition of a named argument.
 #define IGOR_MAKE_NAMED_ARGUMENT(name)                                                                                 \
     inline constexpr auto name = ::igor::named_argument<struct name##_tag> {}
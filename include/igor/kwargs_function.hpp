@@ -0,0 +1,337 @@
+// Copyright 2018-2020 Francesco Biscani
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef IGOR_KWARGS_FUNCTION_HPP
+#define IGOR_KWARGS_FUNCTION_HPP
+
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <igor/igor.hpp>
+
+namespace igor
+{
+
+// Exception thrown when invoking an empty kwargs_function.
+class bad_kwargs_call : public ::std::exception
+{
+public:
+    const char *what() const noexcept override
+    {
+        return "An empty igor::kwargs_function was invoked";
+    }
+};
+
+namespace detail
+{
+
+// Position in Args of the first named argument with tag ID id.
+// If no such argument exists, sizeof...(Args) will be returned.
+template <typename... Args>
+constexpr ::std::size_t find_arg_position(tag_id_t id)
+{
+    const auto idx = detail::lower_bound_tag_entry(sorted_tag_entries<Args...>, id);
+
+    if (idx != n_named_arguments<Args...> && sorted_tag_entries<Args...>[idx].id == id) {
+        return sorted_tag_entries<Args...>[idx].index;
+    } else {
+        return sizeof...(Args);
+    }
+}
+
+// Tag type of a named argument.
+template <typename T>
+struct named_argument_tag;
+
+template <typename Tag, typename ExplicitType, typename VoidCondition>
+struct named_argument_tag<named_argument<Tag, ExplicitType, VoidCondition>> {
+    using type = Tag;
+};
+
+// Size of the small buffer of kwargs_function: callables
+// up to this size are stored without heap allocations.
+inline constexpr ::std::size_t kwargs_function_buffer_size = 4u * sizeof(void *);
+
+// Operations performed by the manager of a kwargs_function.
+enum class kwargs_op { copy, move, destroy };
+
+} // namespace detail
+
+// Type-erased callable accepting the named arguments NArgs, which must be
+// explicitly typed with value types. The wrapped callable is invoked with
+// all the named arguments in NArgs, in the declared order: the values not
+// provided at the call site are taken from a set of defaults, which can be
+// passed as named arguments upon construction (and which are otherwise
+// value-initialised). The wrapped callable is thus instantiated only once.
+// Callables up to detail::kwargs_function_buffer_size bytes are stored
+// in an internal buffer, larger ones on the heap. A call results in a
+// single indirect call.
+template <typename R, const auto &... NArgs>
+class kwargs_function
+{
+    template <const auto &NArg>
+    using value_t = typename detail::uncvref_t<decltype(NArg)>::value_type;
+    template <const auto &NArg>
+    using tag_t = typename detail::named_argument_tag<detail::uncvref_t<decltype(NArg)>>::type;
+
+    static_assert((... && !::std::is_reference_v<value_t<NArgs>>),
+                  "The named arguments of a kwargs_function must be explicitly typed with value types.");
+    static_assert(!::igor::has_duplicates<decltype(NArgs = ::std::declval<value_t<NArgs>>())...>(),
+                  "The named arguments of a kwargs_function must be distinct.");
+
+    using defaults_t = detail::flat_storage_t<value_t<NArgs>...>;
+    using ptrs_t = detail::flat_storage_t<const value_t<NArgs> *...>;
+    using invoke_t = R (*)(void *, const ptrs_t &);
+    using manage_t = void (*)(detail::kwargs_op, void *, void *);
+
+    template <typename F>
+    static constexpr bool is_small = sizeof(F) <= detail::kwargs_function_buffer_size
+                                     && alignof(F) <= alignof(::std::max_align_t)
+                                     && ::std::is_nothrow_move_constructible_v<F>;
+
+    template <typename F>
+    static F *target(void *buf)
+    {
+        if constexpr (is_small<F>) {
+            return ::std::launder(reinterpret_cast<F *>(buf));
+        } else {
+            return *::std::launder(reinterpret_cast<F **>(buf));
+        }
+    }
+
+    // Check if F can be invoked with the named arguments in NArgs,
+    // returning a value convertible to R (or anything, if R is void).
+    template <typename F>
+    static constexpr bool is_compatible
+        = ::std::is_invocable_r_v<R, F &, detail::tagged_container<tag_t<NArgs>, const value_t<NArgs> &>...>;
+
+    template <typename F, ::std::size_t... Is>
+    static R invoke_impl(void *buf, const ptrs_t &ptrs, ::std::index_sequence<Is...>)
+    {
+        if constexpr (::std::is_void_v<R>) {
+            // NOTE: discard the return value of the callable, if any.
+            static_cast<void>((*kwargs_function::target<F>(buf))(
+                detail::tagged_container<tag_t<NArgs>, const value_t<NArgs> &>{*detail::storage_get<Is>(ptrs)}...));
+        } else {
+            return (*kwargs_function::target<F>(buf))(
+                detail::tagged_container<tag_t<NArgs>, const value_t<NArgs> &>{*detail::storage_get<Is>(ptrs)}...);
+        }
+    }
+    template <typename F>
+    static R invoke(void *buf, const ptrs_t &ptrs)
+    {
+        return kwargs_function::invoke_impl<F>(buf, ptrs, ::std::index_sequence_for<value_t<NArgs>...>{});
+    }
+    [[noreturn]] static R invoke_empty(void *, const ptrs_t &)
+    {
+        throw bad_kwargs_call{};
+    }
+    // NOTE: incompatible callables are rejected in the constructor,
+    // avoid further errors from the instantiation of invoke().
+    template <typename F>
+    static constexpr invoke_t select_invoke()
+    {
+        if constexpr (is_compatible<F>) {
+            return &kwargs_function::invoke<F>;
+        } else {
+            return &kwargs_function::invoke_empty;
+        }
+    }
+
+    template <typename F>
+    static void manage(detail::kwargs_op op, void *src, void *dst)
+    {
+        if constexpr (is_small<F>) {
+            switch (op) {
+                case detail::kwargs_op::copy:
+                    ::new (dst) F(*kwargs_function::target<F>(src));
+                    break;
+                case detail::kwargs_op::move:
+                    ::new (dst) F(static_cast<F &&>(*kwargs_function::target<F>(src)));
+                    kwargs_function::target<F>(src)->~F();
+                    break;
+                case detail::kwargs_op::destroy:
+                    kwargs_function::target<F>(src)->~F();
+            }
+        } else {
+            switch (op) {
+                case detail::kwargs_op::copy:
+                    ::new (dst) F *(new F(*kwargs_function::target<F>(src)));
+                    break;
+                case detail::kwargs_op::move:
+                    ::new (dst) F *(kwargs_function::target<F>(src));
+                    break;
+                case detail::kwargs_op::destroy:
+                    delete kwargs_function::target<F>(src);
+            }
+        }
+    }
+    static void manage_empty(detail::kwargs_op, void *, void *) {}
+
+    template <typename... Defaults>
+    static defaults_t make_defaults(const Defaults &... defaults)
+    {
+        static_assert(!::igor::has_unnamed_arguments<Defaults...>(),
+                      "The defaults of a kwargs_function must be named arguments.");
+        static_assert(!::igor::has_other_than<Defaults...>(NArgs...),
+                      "Defaults for named arguments not accepted by a kwargs_function were passed.");
+
+        [[maybe_unused]] parser p{defaults...};
+
+        return defaults_t{{kwargs_function::make_default<NArgs>(p)}...};
+    }
+    template <const auto &NArg, typename P>
+    static value_t<NArg> make_default([[maybe_unused]] const P &p)
+    {
+        if constexpr (P::has(NArg)) {
+            return p(NArg);
+        } else {
+            return value_t<NArg>{};
+        }
+    }
+
+    // Pointer to the value of the named argument NArg (the I-th
+    // in NArgs): the value passed in Args, or the default.
+    template <const auto &NArg, ::std::size_t I, typename... Args, typename Ptrs>
+    const value_t<NArg> *arg_ptr([[maybe_unused]] const Ptrs &aptrs) const
+    {
+        using tag_set_t = detail::tag_set<Args...>;
+        constexpr auto pos = detail::find_arg_position<Args...>(tag_set_t::template lookup_id<tag_t<NArg>>());
+
+        if constexpr (pos == sizeof...(Args)) {
+            return __builtin_addressof(detail::storage_get<I>(m_defaults));
+        } else {
+            using arg_t = detail::type_at_t<pos, Args...>;
+            static_assert(
+                detail::is_same_v<detail::uncvref_t<detail::tagged_value_t<arg_t>>, value_t<NArg>>,
+                "The values of the named arguments passed to a kwargs_function must have the declared types.");
+
+            return __builtin_addressof(detail::storage_get<pos>(aptrs)->value);
+        }
+    }
+    template <typename... Args, ::std::size_t... Is>
+    ptrs_t make_ptrs(::std::index_sequence<Is...>, const Args &... args) const
+    {
+        [[maybe_unused]] const detail::flat_storage_t<const Args *...> aptrs{{__builtin_addressof(args)}...};
+
+        return ptrs_t{{this->template arg_ptr<NArgs, Is, Args...>(aptrs)}...};
+    }
+
+public:
+    kwargs_function() : m_defaults{} {}
+    // Wrap the callable f, with the default values of the named arguments
+    // set to defaults (the missing ones will be value-initialised).
+    template <typename F, typename... Defaults,
+              ::std::enable_if_t<!detail::is_same_v<detail::uncvref_t<F>, kwargs_function>, int> = 0>
+    explicit kwargs_function(F &&f, const Defaults &... defaults)
+        : m_invoke(kwargs_function::select_invoke<::std::decay_t<F>>()),
+          m_manage(&kwargs_function::manage<::std::decay_t<F>>),
+          m_defaults(kwargs_function::make_defaults(defaults...))
+    {
+        using f_t = ::std::decay_t<F>;
+        static_assert(::std::is_copy_constructible_v<f_t>, "The callable of a kwargs_function must be copyable.");
+        static_assert(is_compatible<f_t>, "The callable of a kwargs_function must be invocable with the declared "
+                                          "named arguments, and its return value must be convertible to R.");
+
+        if constexpr (is_small<f_t>) {
+            ::new (static_cast<void *>(m_buf)) f_t(static_cast<F &&>(f));
+        } else {
+            ::new (static_cast<void *>(m_buf)) f_t *(new f_t(static_cast<F &&>(f)));
+        }
+    }
+    kwargs_function(const kwargs_function &other)
+        : m_invoke(other.m_invoke), m_manage(other.m_manage), m_defaults(other.m_defaults)
+    {
+        m_manage(detail::kwargs_op::copy, other.m_buf, m_buf);
+    }
+    // NOTE: the moves are noexcept only if the moves of the stored
+    // defaults are (the callable itself is moved without throwing,
+    // either via the small buffer or via the pointer to the heap).
+    kwargs_function(kwargs_function &&other) noexcept((... && ::std::is_nothrow_move_constructible_v<value_t<NArgs>>))
+        : m_invoke(other.m_invoke), m_manage(other.m_manage),
+          m_defaults(static_cast<defaults_t &&>(other.m_defaults))
+    {
+        m_manage(detail::kwargs_op::move, other.m_buf, m_buf);
+        other.m_invoke = &kwargs_function::invoke_empty;
+        other.m_manage = &kwargs_function::manage_empty;
+    }
+    kwargs_function &operator=(const kwargs_function &other)
+    {
+        if (this != &other) {
+            *this = kwargs_function(other);
+        }
+        return *this;
+    }
+    kwargs_function &
+    operator=(kwargs_function &&other) noexcept((... && ::std::is_nothrow_move_assignable_v<value_t<NArgs>>))
+    {
+        if (this != &other) {
+            // NOTE: move the defaults first, so that the stored
+            // callable is left untouched if the move throws.
+            m_defaults = static_cast<defaults_t &&>(other.m_defaults);
+            m_manage(detail::kwargs_op::destroy, m_buf, nullptr);
+            m_invoke = other.m_invoke;
+            m_manage = other.m_manage;
+            m_manage(detail::kwargs_op::move, other.m_buf, m_buf);
+            other.m_invoke = &kwargs_function::invoke_empty;
+            other.m_manage = &kwargs_function::manage_empty;
+        }
+        return *this;
+    }
+    ~kwargs_function()
+    {
+        m_manage(detail::kwargs_op::destroy, m_buf, nullptr);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_invoke != &kwargs_function::invoke_empty;
+    }
+
+    // Invoke the wrapped callable. The arguments args must be named
+    // arguments among NArgs, each appearing at most once, whose values
+    // have the declared types.
+    template <typename... Args>
+    R operator()(const Args &... args) const
+    {
+        static_assert(!::igor::has_unnamed_arguments<Args...>(),
+                      "A kwargs_function can be invoked only with named arguments.");
+        static_assert(!::igor::has_other_than<Args...>(NArgs...),
+                      "Named arguments not accepted by a kwargs_function were passed.");
+        static_assert(!::igor::has_duplicates<Args...>(), "Duplicate named arguments were passed.");
+
+        return m_invoke(m_buf, this->make_ptrs(::std::index_sequence_for<value_t<NArgs>...>{}, args...));
+    }
+
+private:
+    // NOTE: the buffer is mutable because, as in std::function,
+    // the wrapped callable is invoked as a non-const object.
+    alignas(::std::max_align_t) mutable unsigned char m_buf[detail::kwargs_function_buffer_size];
+    invoke_t m_invoke = &kwargs_function::invoke_empty;
+    manage_t m_manage = &kwargs_function::manage_empty;
+    defaults_t m_defaults;
+};
+
+} // namespace igor
+
+#endif
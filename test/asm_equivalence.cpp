@@ -0,0 +1,173 @@
+// Copyright 2018-2020 Francesco Biscani
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Pairs of functions whose generated code is compared by check_asm.cmake:
+// for every function "foo" taking positional arguments, the function "foo_igor"
+// implements the same functionality via named arguments, and it must not emit
+// more instructions than "foo".
+// NOTE: the functions are declared extern "C" so that their symbol names
+// are not mangled.
+
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <utility>
+
+#include <igor/igor.hpp>
+
+using namespace igor;
+
+IGOR_MAKE_NAMED_ARGUMENT(arg1);
+IGOR_MAKE_NAMED_ARGUMENT(arg2);
+IGOR_MAKE_NAMED_ARGUMENT(arg3);
+
+template <typename... Args>
+inline auto add(Args &&... args)
+{
+    parser p{args...};
+    return p(arg1) + p(arg2);
+}
+
+extern "C" int add_int(int a, int b)
+{
+    return a + b;
+}
+
+extern "C" int add_int_igor(int a, int b)
+{
+    return add(arg1 = a, arg2 = b);
+}
+
+extern "C" int add_int_reversed(int a, int b)
+{
+    return a + b;
+}
+
+extern "C" int add_int_reversed_igor(int a, int b)
+{
+    return add(arg2 = b, arg1 = a);
+}
+
+extern "C" double add_double(double a, double b)
+{
+    return a + b;
+}
+
+extern "C" double add_double_igor(double a, double b)
+{
+    return add(arg1 = a, arg2 = b);
+}
+
+// Named arguments explicitly typed with value types. They share
+// the tags of arg1 and arg2, thus add() can fetch them.
+inline constexpr auto arg1_double = named_argument<struct arg1_tag, double>{};
+inline constexpr auto arg2_double = named_argument<struct arg2_tag, double>{};
+
+extern "C" double add_double_by_value(double a, double b)
+{
+    return a + b;
+}
+
+extern "C" double add_double_by_value_igor(double a, double b)
+{
+    return add(arg1_double = a, arg2_double = b);
+}
+
+template <typename... Args>
+inline std::size_t add_sizes(Args &&... args)
+{
+    parser p{args...};
+    return p(arg1).size() + p(arg2).size();
+}
+
+extern "C" std::size_t add_string_sizes(const std::string &a, const std::string &b)
+{
+    return a.size() + b.size();
+}
+
+extern "C" std::size_t add_string_sizes_igor(const std::string &a, const std::string &b)
+{
+    return add_sizes(arg1 = a, arg2 = b);
+}
+
+template <typename... Args>
+inline int add_default(Args &&... args)
+{
+    parser p{args...};
+    if constexpr (p.has(arg2)) {
+        return p(arg1) + p(arg2);
+    } else {
+        return p(arg1) + 42;
+    }
+}
+
+extern "C" int add_int_default(int a)
+{
+    return a + 42;
+}
+
+extern "C" int add_int_default_igor(int a)
+{
+    return add_default(arg1 = a);
+}
+
+// An unfetched lazy value must not emit any code.
+int expensive_value();
+
+extern "C" int add_int_unused_lazy(int a, int b)
+{
+    return a + b;
+}
+
+extern "C" int add_int_unused_lazy_igor(int a, int b)
+{
+    return add(arg1 = a, arg2 = b, arg3 = igor::lazy([]() { return expensive_value(); }));
+}
+
+// NOTE: move-only types are not checked here. With GCC 12, moving
+// a std::unique_ptr out of a parser spills the moved-to object on the stack,
+// because the tagged container is a temporary passed by reference. The
+// same happens without igor whenever a struct holding an rvalue reference
+// is passed to an inline function, so it is not a parser issue.
+
+template <typename... Args>
+inline int sum_list(Args &&... args)
+{
+    parser p{args...};
+    int retval = 0;
+    for (auto x : p(arg1)) {
+        retval += x;
+    }
+    return retval;
+}
+
+extern "C" int sum_init_list(std::initializer_list<int> l)
+{
+    int retval = 0;
+    for (auto x : l) {
+        retval += x;
+    }
+    return retval;
+}
+
+extern "C" int sum_init_list_igor(std::initializer_list<int> l)
+{
+    return sum_list(arg1 = l);
+}
@@ -18,13 +18,20 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <array>
 #include <initializer_list>
+#include <limits>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#include <igor/capture.hpp>
+#include <igor/dispatch.hpp>
 #include <igor/igor.hpp>
+#include <igor/kwargs_function.hpp>
 
 #include "catch.hpp"
 
@@ -268,6 +275,11 @@ TEST_CASE("test_not_provided")
     REQUIRE(!not_provided_test(arg3 = 6, arg1 = 5.));
 }
 
+template <typename T>
+struct type_wrapper_test {
+    using type = T;
+};
+
 template <typename... Args>
 inline bool has_duplicates_test(Args &&... args)
 {
@@ -292,6 +304,28 @@ TEST_CASE("test_has_duplicates")
     REQUIRE(has_duplicates_test(arg1 = 4, arg2 = 56, arg2 = 5, arg1 = 6));
     REQUIRE(has_duplicates_test(arg1 = 4, arg2 = 56, arg2 = 5, arg1 = 6, arg3 = 5.6));
     REQUIRE(has_duplicates_test(arg3 = "Hello", arg1 = 4, arg2 = 56, arg2 = 5, arg1 = 6));
+    // Same tag, different types.
+    REQUIRE(has_duplicates_test(arg1 = 5, arg1 = 6.));
+    REQUIRE(has_duplicates_test(arg1 = 5, "hello", arg2 = 3, arg1 = "world"));
+}
+
+template <typename... Args>
+inline constexpr auto first_duplicate_test(Args &&...)
+{
+    return type_wrapper_test<first_duplicate_t<Args...>>{};
+}
+
+TEST_CASE("test_first_duplicate")
+{
+    REQUIRE(std::is_void_v<first_duplicate_t<>>);
+    REQUIRE(std::is_void_v<first_duplicate_t<int, double>>);
+    REQUIRE(std::is_void_v<decltype(first_duplicate_test(arg1 = 5, arg2 = 6))::type>);
+    REQUIRE(std::is_same_v<decltype(first_duplicate_test(arg1 = 5, arg1 = 6))::type, arg1_tag>);
+    REQUIRE(std::is_same_v<decltype(first_duplicate_test(arg1 = 5, 7, arg1 = 6.))::type, arg1_tag>);
+    REQUIRE(std::is_same_v<decltype(first_duplicate_test(arg3 = 1, arg2 = 5, arg1 = 6, arg2 = 7, arg1 = 8))::type,
+                           arg2_tag>);
+    REQUIRE(std::is_same_v<decltype(first_duplicate_test(arg3 = 1, arg1 = 5, arg2 = 6, arg2 = 7, arg1 = 8))::type,
+                           arg1_tag>);
 }
 
 template <typename... Args>
@@ -371,4 +405,1014 @@ TEST_CASE("repeated_arguments")
     REQUIRE(repeated_args(arg1 = 5) == 5);
     REQUIRE(repeated_args(arg1 = 5, arg1 = 6) == 5);
     REQUIRE(repeated_args(arg1 = 5, arg1 = 6, arg1 = 7) == 5);
+    REQUIRE(repeated_args(arg2 = 4, arg1 = 5, 3, arg1 = 6, arg3 = 8, arg1 = 7) == 5);
+}
+
+TEST_CASE("tag_id")
+{
+    REQUIRE(tag_id<arg1_tag> == tag_id<arg1_tag>);
+    REQUIRE(tag_id<arg1_tag> != tag_id<arg2_tag>);
+    REQUIRE(tag_id<arg4_tag> != tag_id<arg5_tag>);
+    REQUIRE(!tag_id<arg1_tag>.empty());
+    REQUIRE(std::string_view(tag_id<arg1_tag>.data(), tag_id<arg1_tag>.size()).find("arg1_tag")
+            != std::string_view::npos);
+    REQUIRE((tag_id<arg1_tag> < tag_id<arg2_tag>) != (tag_id<arg2_tag> < tag_id<arg1_tag>));
+
+    constexpr bool check = tag_id<arg3_tag> != tag_id<int>;
+    REQUIRE(check);
+
+    // Local tags with the same name in different lambdas have the same ID.
+    // They can be used in separate parsers (using them in the same parser
+    // is a compile-time error).
+    const auto t1 = [] {
+        struct tol;
+        return named_argument<tol>{};
+    }();
+    const auto t2 = [] {
+        struct tol;
+        return named_argument<tol>{};
+    }();
+    REQUIRE(tag_id<decltype(t1 = 1)::tag_type> == tag_id<decltype(t2 = 2)::tag_type>);
+    int one = 1, two = 2;
+    parser p1{t1 = one};
+    parser p2{t2 = two};
+    REQUIRE(p1(t1) == 1);
+    REQUIRE(p2(t2) == 2);
+    REQUIRE(!p2.has_duplicates());
+}
+
+IGOR_MAKE_NAMED_ARGUMENT(arg6);
+IGOR_MAKE_NAMED_ARGUMENT(arg7);
+IGOR_MAKE_NAMED_ARGUMENT(arg8);
+IGOR_MAKE_NAMED_ARGUMENT(arg9);
+
+template <typename... Args>
+inline void many_args_test(Args &&... args)
+{
+    parser p{args...};
+    REQUIRE(p.has_all(arg1, arg2, arg3, arg5, arg6, arg7, arg8, arg9));
+    REQUIRE(!p.has(arg4));
+    REQUIRE(p.has_any(arg4, arg9));
+    REQUIRE(!p.has_any(arg4));
+    REQUIRE(!p.has_other_than(arg1, arg2, arg3, arg5, arg6, arg7, arg8, arg9));
+    REQUIRE(p.has_other_than(arg1, arg2, arg3, arg5, arg6, arg7, arg8));
+    REQUIRE(p(arg9) == 9);
+    REQUIRE(p(arg1) == 1);
+    auto [a2, a3, a5, a6, a7, a8] = p(arg2, arg3, arg5, arg6, arg7, arg8);
+    REQUIRE(a2 == 2);
+    REQUIRE(a3 == 3);
+    REQUIRE(a5 == 5.);
+    REQUIRE(a6 == 6);
+    REQUIRE(a7 == 7);
+    REQUIRE(a8 == 8);
+    REQUIRE(std::is_same_v<decltype(p(arg4)), const not_provided_t &>);
+}
+
+TEST_CASE("many_args")
+{
+    many_args_test(arg9 = 9, arg7 = 7, 42, arg1 = 1, arg5 = {5.}, arg8 = 8, "hello", arg3 = 3, arg6 = 6, arg2 = 2);
+    many_args_test(arg1 = 1, arg2 = 2, arg3 = 3, arg5 = {5.}, arg6 = 6, arg7 = 7, arg8 = 8, arg9 = 9);
+}
+
+template <typename... Args>
+inline bool same_address_test(const void *addr, Args &&... args)
+{
+    parser p{args...};
+    auto &&a = p(arg1);
+    return static_cast<const void *>(&a) == addr;
+}
+
+TEST_CASE("test_value_addresses")
+{
+    int n = 5;
+    REQUIRE(same_address_test(&n, arg1 = n));
+    REQUIRE(same_address_test(&n, arg2 = 3, arg1 = n));
+    REQUIRE(same_address_test(&n, arg1 = std::as_const(n), 4));
+    move_only mo;
+    REQUIRE(same_address_test(&mo, arg1 = std::move(mo)));
+}
+
+TEST_CASE("pack_builtins")
+{
+#if defined(IGOR_DISABLE_BUILTINS)
+#if defined(IGOR_HAVE_TYPE_PACK_ELEMENT) || defined(IGOR_HAVE_IS_SAME)
+#error The compiler builtins should be disabled.
+#endif
+#endif
+
+    REQUIRE(std::is_same_v<detail::type_at_t<0, int>, int>);
+    REQUIRE(std::is_same_v<detail::type_at_t<1, int, const double &, float>, const double &>);
+    REQUIRE(std::is_same_v<detail::type_at_t<2, int, const double &, float>, float>);
+    REQUIRE(detail::is_same_v<int, int>);
+    REQUIRE(!detail::is_same_v<int, const int>);
+    REQUIRE(!detail::is_same_v<int, int &>);
+}
+
+template <typename... Args>
+inline auto canonical_impl(Args &&... args)
+{
+    parser p{args...};
+    return std::make_pair(type_wrapper_test<void(Args &&...)>{}, p(arg1) - p(arg2));
+}
+
+template <typename... Args>
+inline auto canonical(Args &&... args)
+{
+    return canonicalize([](auto &&... a) { return canonical_impl(std::forward<decltype(a)>(a)...); },
+                        std::forward<Args>(args)...);
+}
+
+TEST_CASE("canonicalize")
+{
+    const auto r0 = canonical(arg1 = 5, arg2 = 3);
+    const auto r1 = canonical(arg2 = 3, arg1 = 5);
+    REQUIRE(r0.second == 2);
+    REQUIRE(r1.second == 2);
+    REQUIRE(std::is_same_v<decltype(r0.first), decltype(r1.first)>);
+
+    // Unnamed arguments keep their positions.
+    const auto r2 = canonical(1, arg2 = 3, "hello", arg1 = 5);
+    const auto r3 = canonical(1, arg1 = 5, "hello", arg2 = 3);
+    REQUIRE(r2.second == 2);
+    REQUIRE(r3.second == 2);
+    REQUIRE(std::is_same_v<decltype(r2.first), decltype(r3.first)>);
+    REQUIRE(!std::is_same_v<decltype(r0.first), decltype(r2.first)>);
+
+    // Different value categories result in different instantiations.
+    int n = 5;
+    const auto r4 = canonical(arg2 = 3, arg1 = n);
+    REQUIRE(r4.second == 2);
+    REQUIRE(!std::is_same_v<decltype(r0.first), decltype(r4.first)>);
+
+    // Perfect forwarding.
+    move_only mo;
+    canonicalize([](auto &&... a) { move_argument(std::forward<decltype(a)>(a)...); }, arg2 = 3,
+                 arg1 = std::move(mo));
+
+    // Repeated arguments keep their relative order.
+    REQUIRE(canonicalize([](auto &&... a) { return repeated_args(std::forward<decltype(a)>(a)...); }, arg2 = 1,
+                         arg1 = 5, arg1 = 6)
+            == 5);
+
+    // Constexpr.
+    constexpr auto c = canonicalize([](auto &&... a) { return sum(std::forward<decltype(a)>(a)...); }, arg2 = 8,
+                                    arg1 = 0.5, arg3 = 7);
+    REQUIRE(c == 56.5);
+}
+
+struct integrator_options {
+    double tol = 1e-9;
+    int order = 4;
+    std::string name = "taylor";
+    std::vector<int> data;
+};
+
+using integrator_signature
+    = signature<integrator_options, field<arg1, &integrator_options::tol>, field<arg2, &integrator_options::order>,
+                field<arg3, &integrator_options::name>, field<arg6, &integrator_options::data>>;
+
+// Non-template implementation.
+std::string integrate(const integrator_options &opts)
+{
+    return opts.name + ":" + std::to_string(opts.order) + ":" + std::to_string(opts.tol) + ":"
+           + std::to_string(opts.data.size());
+}
+
+template <typename... Args, std::enable_if_t<integrator_signature::accepts<Args...>, int> = 0>
+std::string integrate(Args &&... args)
+{
+    return integrate(integrator_signature::lower(args...));
+}
+
+TEST_CASE("signature")
+{
+    REQUIRE(integrate() == "taylor:4:" + std::to_string(1e-9) + ":0");
+    REQUIRE(integrate(arg2 = 8) == "taylor:8:" + std::to_string(1e-9) + ":0");
+    REQUIRE(integrate(arg2 = 8, arg1 = 1e-3) == "taylor:8:" + std::to_string(1e-3) + ":0");
+    REQUIRE(integrate(arg3 = "euler", arg1 = 0.5f) == "euler:4:" + std::to_string(0.5) + ":0");
+
+    // Moving in.
+    std::vector<int> v{1, 2, 3};
+    const auto *ptr = v.data();
+    const auto opts = integrator_signature::lower(arg6 = std::move(v));
+    REQUIRE(opts.data.size() == 3u);
+    REQUIRE(opts.data.data() == ptr);
+
+    REQUIRE(integrator_signature::accepts<>);
+    REQUIRE(integrator_signature::accepts<decltype(arg1 = 1.)>);
+    REQUIRE(!integrator_signature::accepts<int>);
+    REQUIRE(!integrator_signature::accepts<decltype(arg5 = {1.})>);
+    REQUIRE(!integrator_signature::accepts<decltype(arg1 = 1.), decltype(arg1 = 2.)>);
+}
+
+struct expensive_default {
+    expensive_default() = delete;
+    explicit expensive_default(int *counter) : value(42)
+    {
+        ++*counter;
+    }
+    int value;
+};
+
+template <typename... Args>
+inline int get_or_test(int *counter, Args &&... args)
+{
+    parser p{args...};
+    decltype(auto) a = p.get_or(arg1, [counter]() { return expensive_default{counter}; });
+    if constexpr (p.has(arg1)) {
+        REQUIRE(std::is_rvalue_reference_v<decltype(a)>);
+        return a;
+    } else {
+        REQUIRE(std::is_same_v<decltype(a), expensive_default>);
+        return a.value;
+    }
+}
+
+TEST_CASE("get_or")
+{
+    int counter = 0;
+    REQUIRE(get_or_test(&counter, arg1 = 1) == 1);
+    REQUIRE(counter == 0);
+    REQUIRE(get_or_test(&counter, arg2 = 1, 5) == 42);
+    REQUIRE(counter == 1);
+    REQUIRE(get_or_test(&counter) == 42);
+    REQUIRE(counter == 2);
+
+    // A present argument is returned by reference.
+    {
+        int n = 5;
+        parser p{arg1 = n};
+        REQUIRE(&p.get_or(arg1, []() { return 0; }) == &n);
+    }
+
+    // The default callable is instantiated only if the argument is missing.
+    {
+        int n = 5;
+        parser p{arg1 = n};
+        REQUIRE(p.get_or(arg1, [](auto... x) { return std::string(x...); }) == 5);
+    }
+
+    // Constexpr.
+    {
+        constexpr auto r = parser{arg2 = 3}.get_or(arg1, []() { return 7; });
+        REQUIRE(r == 7);
+    }
+}
+
+struct move_only_result {
+    move_only_result(int n) : value(n) {}
+    move_only_result(move_only_result &&) = default;
+    int value;
+};
+
+template <typename... Args>
+inline int lazy_test(Args &&... args)
+{
+    parser p{args...};
+    if constexpr (p.has(arg1)) {
+        return p(arg1);
+    } else {
+        return -1;
+    }
+}
+
+TEST_CASE("lazy")
+{
+    int counter = 0;
+    auto f = [&counter]() {
+        ++counter;
+        return 42;
+    };
+
+    // Unfetched lazy values are never evaluated.
+    REQUIRE(lazy_test(arg2 = igor::lazy(f)) == -1);
+    REQUIRE(counter == 0);
+    {
+        parser p{arg1 = igor::lazy(f)};
+        REQUIRE(p.has(arg1));
+        REQUIRE(counter == 0);
+    }
+
+    // Fetched lazy values are evaluated on fetch.
+    REQUIRE(lazy_test(arg1 = igor::lazy(f)) == 42);
+    REQUIRE(counter == 1);
+    {
+        auto l = igor::lazy(f);
+        parser p{arg1 = l};
+        REQUIRE(std::is_same_v<decltype(p(arg1)), int>);
+        REQUIRE(p(arg1) == 42);
+        REQUIRE(p(arg1) == 42);
+        REQUIRE(counter == 3);
+    }
+
+    // Lazy values returning references.
+    {
+        int n = 5;
+        const auto l = igor::lazy([&n]() -> int & { return n; });
+        parser p{arg1 = l};
+        REQUIRE(&p(arg1) == &n);
+    }
+
+    // Fetch via get_or().
+    {
+        auto l = igor::lazy(f);
+        parser p{arg1 = l};
+        REQUIRE(p.get_or(arg1, []() { return 0; }) == 42);
+        REQUIRE(counter == 4);
+    }
+
+    // Multiple fetch, mixed with plain and missing arguments.
+    {
+        int n = 1;
+        auto l = igor::lazy([]() { return move_only_result{3}; });
+        parser p{arg1 = n, arg2 = l};
+        auto [a, b, c] = p(arg1, arg2, arg3);
+        REQUIRE(&a == &n);
+        REQUIRE(std::is_same_v<decltype(b), move_only_result>);
+        REQUIRE(b.value == 3);
+        REQUIRE(std::is_same_v<decltype(c), const not_provided_t &>);
+
+        const auto t = p(arg1, arg2);
+        REQUIRE(t.get<1>().value == 3);
+        REQUIRE(std::is_same_v<decltype(t.get<1>()), const move_only_result &>);
+        auto mo = std::move(p(arg1, arg2)).get<1>();
+        REQUIRE(mo.value == 3);
+    }
+}
+
+template <typename... Args>
+inline int ct_kernel(Args &&... args)
+{
+    parser p{args...};
+    if constexpr (p.has(arg1)) {
+        if constexpr (p.constant(arg1) == 4) {
+            return 4;
+        } else {
+            return -static_cast<int>(p.constant(arg1));
+        }
+    } else {
+        return 0;
+    }
+}
+
+TEST_CASE("ct")
+{
+    REQUIRE(ct_kernel(arg1 = igor::ct<4>) == 4);
+    REQUIRE(ct_kernel(arg1 = igor::ct<5>) == -5);
+    REQUIRE(ct_kernel(arg1 = igor::ct<5l>, arg2 = 1) == -5);
+    REQUIRE(ct_kernel(arg1 = std::integral_constant<short, 3>{}) == -3);
+    REQUIRE(ct_kernel(arg2 = 1) == 0);
+
+    parser p{arg1 = igor::ct<true>, arg2 = igor::ct<3u>};
+    REQUIRE(std::is_same_v<decltype(p.constant(arg1)), bool>);
+    REQUIRE(std::is_same_v<decltype(p.constant(arg2)), unsigned>);
+    static_assert(p.constant(arg1));
+    static_assert(p.constant(arg2) == 3u);
+
+    // Compile-time values are also usable as runtime values.
+    REQUIRE(p(arg2) == 3u);
+    REQUIRE(&p(arg2) == &igor::ct<3u>);
+}
+
+enum class method { euler = 1, rk4 = 4, taylor = 7 };
+
+template <method M>
+inline int integrate_with()
+{
+    static_assert(M == method::euler || M == method::rk4 || M == method::taylor);
+    return static_cast<int>(M) * 10;
+}
+
+template <typename... Args>
+inline int dispatch_test(Args &&... args)
+{
+    parser p{args...};
+    return igor::dispatch<method::euler, method::rk4, method::taylor>(
+        p, arg1, [](auto m) { return integrate_with<decltype(m)::value>(); });
+}
+
+TEST_CASE("dispatch")
+{
+    REQUIRE(dispatch_test(arg1 = method::euler) == 10);
+    REQUIRE(dispatch_test(arg1 = method::rk4, arg2 = 1) == 40);
+    REQUIRE(dispatch_test(arg2 = 1, arg1 = method::taylor) == 70);
+    REQUIRE_THROWS_AS(dispatch_test(arg1 = static_cast<method>(2)), igor::bad_dispatch);
+    REQUIRE_THROWS_AS(dispatch_test(arg1 = static_cast<method>(0)), igor::bad_dispatch);
+    REQUIRE_THROWS_AS(dispatch_test(arg1 = static_cast<method>(8)), igor::bad_dispatch);
+    REQUIRE_THROWS_AS(dispatch_test(arg1 = static_cast<method>(-100)), igor::bad_dispatch);
+
+    // Integral choices, with negative values and in arbitrary order.
+    int n = -3;
+    parser p{arg1 = n};
+    auto visitor = [](auto c) -> long { return decltype(c)::value * 2; };
+    REQUIRE(igor::dispatch<2, -3, 0>(p, arg1, visitor) == -6);
+    n = 2;
+    REQUIRE(igor::dispatch<2, -3, 0>(p, arg1, visitor) == 4);
+    n = -1;
+    REQUIRE_THROWS_AS((igor::dispatch<2, -3, 0>(p, arg1, visitor)), igor::bad_dispatch);
+    n = 1;
+    REQUIRE(igor::dispatch<1>(p, arg1, visitor) == 2);
+
+    // Unsigned and bool choices.
+    unsigned u = 5;
+    bool b = true;
+    parser pu{arg1 = u, arg2 = b};
+    REQUIRE(igor::dispatch<5u, 6u>(pu, arg1, [](auto c) { return decltype(c)::value; }) == 5u);
+    REQUIRE(igor::dispatch<false, true>(pu, arg2, [](auto c) { return static_cast<int>(c()); }) == 1);
+
+    // Values which do not survive the conversion to the type of the choices.
+    long l = (1l << 32) | 1l;
+    int m = -1;
+    u = 4294967295u;
+    parser pn{arg1 = l, arg2 = m, arg3 = u};
+    auto int_visitor = [](auto c) { return static_cast<int>(decltype(c)::value); };
+    if constexpr (sizeof(long) > sizeof(int)) {
+        REQUIRE_THROWS_AS((igor::dispatch<0, 1, 2>(pn, arg1, int_visitor)), igor::bad_dispatch);
+    }
+    REQUIRE_THROWS_AS((igor::dispatch<4294967294u, 4294967295u>(pn, arg2, int_visitor)), igor::bad_dispatch);
+    REQUIRE_THROWS_AS((igor::dispatch<-1, 0>(pn, arg3, int_visitor)), igor::bad_dispatch);
+    l = 1;
+    REQUIRE(igor::dispatch<0, 1, 2>(pn, arg1, int_visitor) == 1);
+
+    // Floating-point values are dispatched only if equal to one of the choices.
+    double d = 1.7;
+    parser pd{arg1 = d};
+    REQUIRE_THROWS_AS((igor::dispatch<0, 1, 2>(pd, arg1, int_visitor)), igor::bad_dispatch);
+    d = -0.5;
+    REQUIRE_THROWS_AS((igor::dispatch<0, 1, 2>(pd, arg1, int_visitor)), igor::bad_dispatch);
+    d = 1e300;
+    REQUIRE_THROWS_AS((igor::dispatch<0, 1, 2>(pd, arg1, int_visitor)), igor::bad_dispatch);
+    d = std::numeric_limits<double>::quiet_NaN();
+    REQUIRE_THROWS_AS((igor::dispatch<0, 1, 2>(pd, arg1, int_visitor)), igor::bad_dispatch);
+    d = 1.;
+    REQUIRE(igor::dispatch<0, 1, 2>(pd, arg1, int_visitor) == 1);
+    d = 2.;
+    REQUIRE(igor::dispatch<2, 0, 1>(pd, arg1, int_visitor) == 2);
+
+    // Choices at the edges of the range of a 64-bit integral.
+    unsigned long long ull = ~0ull;
+    parser pe{arg1 = ull};
+    REQUIRE(igor::dispatch<~0ull - 1u, ~0ull>(pe, arg1, [](auto c) { return c() == ~0ull; }));
+    ull = 0;
+    REQUIRE_THROWS_AS((igor::dispatch<~0ull - 1u, ~0ull>(pe, arg1, [](auto c) { return c() == ~0ull; })),
+                      igor::bad_dispatch);
+}
+
+inline constexpr auto tol = ::igor::named_argument<struct tol_tag, double>{};
+inline constexpr auto name = ::igor::named_argument<struct name_tag, std::string>{};
+inline constexpr auto big = ::igor::named_argument<struct big_tag, std::array<double, 64>>{};
+
+template <typename... Args>
+inline auto by_value_test(Args &&... args)
+{
+    parser p{args...};
+    REQUIRE((!p.has(tol) || std::is_same_v<decltype(p(tol)), const double &>));
+    return p;
+}
+
+inline constexpr auto up = ::igor::named_argument<struct up_tag, std::unique_ptr<int>>{};
+
+template <typename... Args>
+inline int by_value_move_only_test(Args &&... args)
+{
+    parser p{args...};
+    REQUIRE(std::is_same_v<decltype(p(up)), const std::unique_ptr<int> &>);
+    return *p(up);
+}
+
+TEST_CASE("explicit value types")
+{
+    REQUIRE(std::is_assignable_v<decltype(tol), double>);
+    REQUIRE(std::is_assignable_v<decltype(tol), double &>);
+    REQUIRE(std::is_assignable_v<decltype(tol), const double &>);
+    REQUIRE(!std::is_assignable_v<decltype(tol), int>);
+    REQUIRE(!std::is_assignable_v<decltype(tol), float &>);
+    REQUIRE(std::is_same_v<decltype(tol = 1.), detail::tagged_container<tol_tag, double>>);
+    REQUIRE(std::is_same_v<decltype(tol = {1}), detail::tagged_container<tol_tag, double>>);
+
+    // The parser stores a copy of the value, thus it
+    // can outlive the tagged containers.
+    auto p = by_value_test(tol = {1}, arg1 = 5);
+    REQUIRE(p(tol) == 1.);
+    REQUIRE(p.has(tol));
+    double d = 2;
+    auto p2 = parser{tol = d};
+    REQUIRE(p2(tol) == 2.);
+    REQUIRE(&p2(tol) != &d);
+
+    // Constexpr.
+    constexpr auto p3 = parser{tol = 3.};
+    static_assert(p3(tol) == 3.);
+
+    // Non-trivially copyable types, moved into the container. They
+    // are not copied into the parser, which refers to the container.
+    std::string s = "hello";
+    auto nc = (name = std::move(s));
+    auto tc = (tol = {4.f});
+    parser p4{nc, tc};
+    auto [n, t] = p4(name, tol);
+    REQUIRE(n == "hello");
+    REQUIRE(t == 4.);
+    REQUIRE(std::is_same_v<decltype(n), const std::string &>);
+    REQUIRE(&n == &nc.value);
+    REQUIRE(&t != &tc.value);
+    p4.forward([&](const auto &c) { REQUIRE(&c.value == &nc.value); }, name);
+
+    // Large trivially copyable types are not copied either.
+    auto bc = (big = std::array<double, 64>{1., 2.});
+    parser p5{bc};
+    REQUIRE(sizeof(p5) == sizeof(void *));
+    REQUIRE(&p5(big) == &bc.value);
+    REQUIRE(p5(big)[1] == 2.);
+
+    // Move-only types.
+    REQUIRE(by_value_move_only_test(up = std::make_unique<int>(42)) == 42);
+}
+
+template <typename... Args>
+inline int sum_all(Args &&... args)
+{
+    parser p{args...};
+    int retval = 0;
+    if constexpr (p.has(arg1)) {
+        for (auto x : p.all(arg1)) {
+            retval += x;
+        }
+    }
+    return retval;
+}
+
+TEST_CASE("all")
+{
+    REQUIRE(sum_all() == 0);
+    REQUIRE(sum_all(arg2 = 1, 2) == 0);
+    REQUIRE(sum_all(arg1 = 5) == 5);
+    REQUIRE(sum_all(arg1 = 5, arg1 = 6) == 11);
+    REQUIRE(sum_all(arg2 = 4, arg1 = 5, 3, arg1 = 6, arg3 = 8, arg1 = 7) == 18);
+
+    // Same types: array-like, in call order.
+    {
+        int a = 1, b = 2, c = 3;
+        parser p{arg1 = a, arg2 = b, arg1 = c, arg1 = b};
+        auto r = p.all(arg1);
+        REQUIRE(r.size() == 3u);
+        REQUIRE(&r[0] == &a);
+        REQUIRE(&r[1] == &c);
+        REQUIRE(&r[2] == &b);
+        REQUIRE(std::is_same_v<decltype(r[0]), int &>);
+        auto &[x, y, z] = r;
+        REQUIRE(&x == &a);
+        REQUIRE(&y == &c);
+        REQUIRE(&z == &b);
+
+        REQUIRE(p.all(arg2).size() == 1u);
+        REQUIRE(&p.all(arg2)[0] == &b);
+        auto e = p.all(arg3);
+        REQUIRE(e.size() == 0u);
+        REQUIRE(e.begin() == e.end());
+    }
+
+    // References of different kinds to the same type: array-like, as const references.
+    {
+        int a = 1;
+        const int b = 2;
+        REQUIRE(sum_all(arg1 = a, arg1 = 5) == 6);
+        REQUIRE(sum_all(arg1 = 5, arg1 = b, arg1 = a) == 8);
+
+        parser p{arg1 = a, arg1 = std::move(a), arg1 = b};
+        auto r = p.all(arg1);
+        REQUIRE(std::is_same_v<decltype(r[0]), const int &>);
+        REQUIRE(r.size() == 3u);
+        REQUIRE(&r[0] == &a);
+        REQUIRE(&r[1] == &a);
+        REQUIRE(&r[2] == &b);
+    }
+
+    // Different types: tuple-like.
+    {
+        int a = 1;
+        std::string s = "hello";
+        parser p{arg1 = a, arg1 = std::move(s)};
+        auto [x, y] = p.all(arg1);
+        REQUIRE(&x == &a);
+        REQUIRE(std::is_same_v<decltype(y), std::string &&>);
+        REQUIRE(y == "hello");
+    }
+
+    // Explicitly-typed named arguments stored by value.
+    {
+        parser p{tol = 1., tol = 2.};
+        auto r = p.all(tol);
+        REQUIRE(std::is_same_v<decltype(r[0]), const double &>);
+        REQUIRE(r[0] == 1.);
+        REQUIRE(r[1] == 2.);
+    }
+}
+
+template <typename... Args>
+inline auto unnamed_test(Args &&... args)
+{
+    parser<Args &&...> p{args...};
+    return std::pair{p(arg1), std::string(p.template unnamed<1>())};
+}
+
+TEST_CASE("unnamed")
+{
+    // CTAD: const lvalue references.
+    {
+        int a = 1;
+        std::string s = "hello";
+        parser p{arg1 = 5, a, arg2 = 6, s};
+        REQUIRE(&p.unnamed<0>() == &a);
+        REQUIRE(&p.unnamed<1>() == &s);
+        REQUIRE(std::is_same_v<decltype(p.unnamed<0>()), const int &>);
+        REQUIRE(std::is_same_v<decltype(p.unnamed<1>()), const std::string &>);
+        auto [x, y] = p.unnamed();
+        REQUIRE(&x == &a);
+        REQUIRE(&y == &s);
+        REQUIRE(std::tuple_size<decltype(parser{arg1 = 5}.unnamed())>::value == 0u);
+    }
+
+    // Perfect forwarding.
+    {
+        int a = 1;
+        std::string s = "hello";
+        int five = 5;
+        auto c = (arg1 = five);
+        parser<decltype(c) &, int &, std::string &&> p{c, a, s};
+        REQUIRE(&p(arg1) == &five);
+        REQUIRE(std::is_same_v<decltype(p.unnamed<0>()), int &>);
+        REQUIRE(std::is_same_v<decltype(p.unnamed<1>()), std::string &&>);
+        auto [x, y] = p.unnamed();
+        REQUIRE(std::is_same_v<decltype(y), std::string &&>);
+        REQUIRE(&x == &a);
+        std::string t = p.unnamed<1>();
+        REQUIRE(t == "hello");
+        REQUIRE(s.empty());
+    }
+
+    // Named arguments work as usual with reference ParseArgs.
+    {
+        std::string s = "world";
+        auto [n, str] = unnamed_test(arg1 = 3, 1, std::move(s));
+        REQUIRE(n == 3);
+        REQUIRE(str == "world");
+        REQUIRE(s.empty());
+    }
+}
+
+template <typename... Args>
+inline std::string capture_front(Args &&... args)
+{
+    parser p{args...};
+    std::string retval = std::to_string(p(arg1));
+    if constexpr (p.has(arg2)) {
+        retval += p(arg2);
+    }
+    return retval;
+}
+
+TEST_CASE("capture")
+{
+    // Rvalues are moved in, lvalues are copied.
+    {
+        std::string s = "hello";
+        std::string t = "world";
+        auto b = igor::capture(arg1 = 1, arg2 = std::move(s), arg3 = t);
+        REQUIRE(s.empty());
+        t = "changed";
+        auto p = b.parser();
+        REQUIRE(p(arg1) == 1);
+        REQUIRE(p(arg2) == "hello");
+        REQUIRE(p(arg3) == "world");
+        REQUIRE(std::is_same_v<decltype(p(arg2)), std::string &>);
+        REQUIRE(std::is_same_v<decltype(std::as_const(b).parser()(arg2)), const std::string &>);
+        REQUIRE(b.apply([](auto &&... args) { return capture_front(args...); }) == "1hello");
+    }
+
+    // The bundle outlives the arguments.
+    {
+        auto make = []() {
+            std::string s = "abc";
+            return igor::capture(arg2 = s, arg1 = 42);
+        };
+        auto b = make();
+        REQUIRE(b.apply([](auto &&... args) { return capture_front(args...); }) == "42abc");
+    }
+
+    // Lvalues by reference on request.
+    {
+        int n = 1;
+        auto b = igor::capture(igor::by_ref(arg1 = n), arg2 = n);
+        n = 2;
+        auto p = b.parser();
+        REQUIRE(&p(arg1) == &n);
+        REQUIRE(p(arg2) == 1);
+    }
+
+    // Move-only values, moved out of an rvalue bundle.
+    {
+        auto b = igor::capture(arg1 = std::make_unique<int>(5), 7);
+        auto b2 = std::move(b);
+        auto ptr = std::move(b2).apply([](auto &&... args) {
+            parser p{args...};
+            REQUIRE(p.template unnamed<0>() == 7);
+            return std::unique_ptr<int>(p(arg1));
+        });
+        REQUIRE(*ptr == 5);
+    }
+
+    // Unnamed arguments.
+    {
+        int n = 3;
+        const auto b = igor::capture(arg1 = 1, n, static_cast<const char *>("hello"));
+        auto p = b.parser();
+        REQUIRE(p.unnamed<0>() == 3);
+        REQUIRE(&p.unnamed<0>() != &n);
+        REQUIRE(std::is_same_v<decltype(p.unnamed<1>()), const char *const &>);
+    }
+
+    // Empty values take no space.
+    {
+        double d = 1;
+        auto b = igor::capture(arg1 = igor::ct<4>, arg2 = d, arg3 = igor::ct<true>);
+        REQUIRE(sizeof(b) == sizeof(double));
+        auto p = b.parser();
+        static_assert(decltype(p)::constant(arg1) == 4);
+        static_assert(decltype(p)::constant(arg3));
+        REQUIRE(p(arg2) == 1.);
+    }
+
+    // Lazy values.
+    {
+        int counter = 0;
+        auto b = igor::capture(arg1 = igor::lazy([&counter]() { return ++counter; }));
+        REQUIRE(counter == 0);
+        REQUIRE(b.parser()(arg1) == 1);
+        REQUIRE(counter == 1);
+    }
+}
+
+struct bind_front_end {
+    template <typename... Args>
+    std::string operator()(Args &&... args) const
+    {
+        parser p{args...};
+        REQUIRE(!p.has_duplicates());
+        std::string retval = std::to_string(p(arg1));
+        if constexpr (p.has(arg2)) {
+            retval += p(arg2);
+        }
+        if constexpr (p.has_unnamed_arguments()) {
+            retval += std::to_string(p.template unnamed<0>());
+        }
+        return retval;
+    }
+};
+
+TEST_CASE("bind")
+{
+    std::string s = "a";
+    auto f = igor::bind(bind_front_end{}, arg1 = 1, arg2 = s);
+    s = "changed";
+    REQUIRE(sizeof(f) == sizeof(decltype(igor::capture(arg1 = 1, arg2 = s))));
+    REQUIRE(f() == "1a");
+    REQUIRE(std::as_const(f)() == "1a");
+
+    // Call-time arguments override the stored ones.
+    REQUIRE(f(arg1 = 2) == "2a");
+    REQUIRE(f(arg2 = "b") == "1b");
+    REQUIRE(f(arg2 = "b", arg1 = 3) == "3b");
+
+    // Unnamed arguments: stored ones first.
+    REQUIRE(f(5) == "1a5");
+    auto g = igor::bind(bind_front_end{}, 7, arg1 = 1);
+    REQUIRE(g(5, arg1 = 4) == "47");
+
+    // Moving out of an rvalue bound function.
+    auto h = igor::bind(
+        [](auto &&... args) {
+            parser p{args...};
+            return std::unique_ptr<int>(std::move(p(arg1)));
+        },
+        arg1 = std::make_unique<int>(5));
+    auto ptr = std::move(h)();
+    REQUIRE(*ptr == 5);
+}
+
+inline constexpr auto order = ::igor::named_argument<struct order_tag, int>{};
+
+// A type whose moves may throw.
+struct throwing_move {
+    throwing_move() = default;
+    throwing_move(const throwing_move &) = default;
+    throwing_move(throwing_move &&) noexcept(false) {}
+    throwing_move &operator=(const throwing_move &) = default;
+    throwing_move &operator=(throwing_move &&) noexcept(false)
+    {
+        return *this;
+    }
+};
+
+inline constexpr auto tm_arg = ::igor::named_argument<struct tm_arg_tag, throwing_move>{};
+
+struct kwargs_kernel {
+    template <typename... Args>
+    std::string operator()(Args &&... args) const
+    {
+        parser p{args...};
+        REQUIRE(sizeof...(Args) == 3u);
+        REQUIRE(std::is_same_v<decltype(p(tol)), const double &>);
+        return std::to_string(p(order)) + p(name) + std::to_string(static_cast<int>(p(tol)));
+    }
+};
+
+TEST_CASE("kwargs_function")
+{
+    using kernel_t = igor::kwargs_function<std::string, order, tol, name>;
+
+    kernel_t k(kwargs_kernel{}, tol = 2., name = std::string("x"));
+    REQUIRE(k);
+    REQUIRE(k() == "0x2");
+    REQUIRE(k(order = 4) == "4x2");
+    REQUIRE(k(name = std::string("y"), order = 1, tol = 3.) == "1y3");
+    REQUIRE(k(tol = {5}) == "0x5");
+
+    // Captures, small and large.
+    int counter = 0;
+    kernel_t small([&counter](auto &&... args) {
+        parser p{args...};
+        ++counter;
+        return std::to_string(p(order));
+    });
+    REQUIRE(small(order = 3) == "3");
+    REQUIRE(counter == 1);
+
+    std::string big_state(100, 'a');
+    std::vector<int> v(10, 1);
+    kernel_t big([big_state, v, counter](auto &&... args) {
+        parser p{args...};
+        return big_state.substr(0, static_cast<std::size_t>(p(order))) + std::to_string(v.size() + counter);
+    });
+    REQUIRE(big(order = 2) == "aa11");
+
+    // Copy, move, assignment.
+    auto big2 = big;
+    REQUIRE(big2(order = 1) == "a11");
+    auto big3 = std::move(big2);
+    REQUIRE(!big2);
+    REQUIRE(big3(order = 1) == "a11");
+    big2 = big3;
+    REQUIRE(big2(order = 3) == "aaa11");
+    big2 = small;
+    REQUIRE(big2(order = 5) == "5");
+    REQUIRE(counter == 2);
+    small = std::move(big3);
+    REQUIRE(small(order = 1) == "a11");
+
+    // Empty.
+    kernel_t empty;
+    REQUIRE(!empty);
+    REQUIRE_THROWS_AS(empty(order = 1), igor::bad_kwargs_call);
+
+    // Heterogeneous kernels in a registry.
+    std::vector<kernel_t> registry;
+    registry.emplace_back(kwargs_kernel{});
+    registry.emplace_back([](auto &&... args) {
+        parser p{args...};
+        return p(name);
+    }, name = std::string("default"));
+    REQUIRE(registry[0](order = 1) == "10");
+    REQUIRE(registry[1]() == "default");
+    REQUIRE(registry[1](name = std::string("z")) == "z");
+
+    // A void kwargs_function discards the return value of the callable.
+    int total = 0;
+    igor::kwargs_function<void, order> vk([&total](auto &&... args) {
+        parser p{args...};
+        total += p(order);
+        return total;
+    });
+    vk(order = 3);
+    vk();
+    vk(order = 4);
+    REQUIRE(total == 7);
+    REQUIRE(std::is_void_v<decltype(vk())>);
+
+    // The moves are noexcept only if the moves of the defaults are.
+    REQUIRE(std::is_nothrow_move_constructible_v<kernel_t>);
+    REQUIRE(std::is_nothrow_move_assignable_v<kernel_t>);
+    REQUIRE(!std::is_nothrow_move_constructible_v<igor::kwargs_function<int, order, tm_arg>>);
+    REQUIRE(!std::is_nothrow_move_assignable_v<igor::kwargs_function<int, order, tm_arg>>);
+}
+
+template <typename... Args>
+inline std::string forward_inner(Args &&... args)
+{
+    parser p{args...};
+    REQUIRE(!p.has(arg3));
+    std::string retval;
+    if constexpr (p.has(arg1)) {
+        retval += std::to_string(p(arg1));
+    }
+    if constexpr (p.has(arg2)) {
+        retval += p(arg2);
+    }
+    if constexpr (p.has_unnamed_arguments()) {
+        retval += std::to_string(p.template unnamed<0>());
+    }
+    return retval;
+}
+
+template <typename... Args>
+inline std::string forward_outer(Args &&... args)
+{
+    parser p{args...};
+    const auto inner = [](auto &&... a) { return forward_inner(a...); };
+    return p.forward(inner, arg1, arg2) + "|" + p.without(arg3).forward(inner, arg2, arg1) + "|"
+           + p.without(arg3).unnamed().template get<0>() + "|"
+           + std::to_string(decltype(p.without(arg3))::has_unnamed_arguments());
+}
+
+TEST_CASE("forward and without")
+{
+    REQUIRE(forward_outer(arg1 = 1, arg2 = std::string("a"), arg3 = 5., std::string("u"))
+            == "1a|1a|u|1");
+
+    // Zero copies.
+    {
+        int n = 1;
+        std::string s = "hello";
+        parser p{arg1 = n, arg2 = std::move(s), arg3 = 3, tol = 4.};
+        p.forward(
+            [&n](auto &&... args) {
+                parser q{args...};
+                REQUIRE(sizeof...(args) == 2u);
+                REQUIRE(&q(arg1) == &n);
+                REQUIRE(std::is_same_v<decltype(q(arg2)), std::string &&>);
+            },
+            arg1, arg5, arg2);
+
+        auto w = p.without(arg2, arg3);
+        REQUIRE(w.has(arg1));
+        REQUIRE(!w.has_any(arg2, arg3));
+        REQUIRE(&w(arg1) == &n);
+        REQUIRE(&w(tol) == &p(tol));
+        REQUIRE(w.without(arg1, tol).has_any(arg1, arg2, arg3, tol) == false);
+    }
+
+    // Lazy values are not evaluated when forwarded.
+    {
+        int counter = 0;
+        auto l = igor::lazy([&counter]() { return ++counter; });
+        parser p{arg1 = l};
+        p.forward([](auto &&...) {}, arg1);
+        REQUIRE(counter == 0);
+        REQUIRE(p.without(arg2)(arg1) == 1);
+        REQUIRE(counter == 1);
+    }
+
+    // All the occurrences are removed.
+    {
+        int a = 1, b = 2, c = 3;
+        parser p{arg1 = a, b, arg1 = c, arg2 = 4};
+        REQUIRE(!p.without(arg1).has(arg1));
+        REQUIRE(p.without(arg1).unnamed<0>() == 2);
+        REQUIRE(p.without(arg2).all(arg1).size() == 2u);
+    }
+}
+
+template <typename Defaults, typename... Args>
+inline std::string merge_test(const Defaults &defaults, Args &&... args)
+{
+    auto p = igor::merge(defaults, args...);
+    REQUIRE(!p.has_duplicates());
+    REQUIRE(p.all(arg1).size() == 1u);
+    return std::to_string(p(arg1)) + p(arg2) + std::to_string(static_cast<int>(p(tol)));
+}
+
+TEST_CASE("merge")
+{
+    const auto defaults = igor::capture(tol = 1., arg1 = 1, arg2 = std::string("d"));
+
+    REQUIRE(merge_test(defaults) == "1d1");
+    REQUIRE(merge_test(defaults, arg1 = 5) == "5d1");
+    REQUIRE(merge_test(defaults, arg2 = "u", tol = 3.) == "1u3");
+    REQUIRE(merge_test(defaults, arg2 = "u", arg1 = 2, tol = {4}) == "2u4");
+
+    // The merged parser refers to the defaults and to the arguments.
+    int n = 7;
+    auto p = igor::merge(defaults, arg1 = n, arg3 = 1);
+    REQUIRE(&p(arg1) == &n);
+    REQUIRE(p.has_all(arg1, arg2, arg3, tol));
+    REQUIRE(std::is_same_v<decltype(p(arg2)), const std::string &>);
+    REQUIRE(&p(arg2) == &defaults.parser()(arg2));
+
+    // Unnamed arguments.
+    auto d2 = igor::capture(arg1 = 1, 42);
+    int m = 3;
+    auto p2 = igor::merge(d2, m);
+    REQUIRE(p2.unnamed<0>() == 3);
+    REQUIRE(p2.unnamed<1>() == 42);
+    REQUIRE(p2(arg1) == 1);
 }
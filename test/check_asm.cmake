@@ -0,0 +1,63 @@
+# Compare the number of instructions emitted for the functions in
+# asm_equivalence.cpp. For every function "foo" in the object file,
+# the function "foo_igor" must not emit more instructions than "foo".
+#
+# Input variables:
+# - OBJDUMP: path to the objdump executable;
+# - OBJECT: path to the object file.
+
+execute_process(COMMAND "${OBJDUMP}" -d -C --no-show-raw-insn "${OBJECT}"
+  OUTPUT_VARIABLE _IGOR_ASM
+  RESULT_VARIABLE _IGOR_RES)
+if(NOT _IGOR_RES EQUAL 0)
+  message(FATAL_ERROR "Error running objdump on '${OBJECT}'.")
+endif()
+
+# Count the instructions of each function.
+string(REPLACE ";" "\;" _IGOR_ASM "${_IGOR_ASM}")
+string(REPLACE "\n" ";" _IGOR_ASM_LINES "${_IGOR_ASM}")
+set(_IGOR_FUNCTIONS "")
+set(_IGOR_CUR_FUNCTION "")
+foreach(_IGOR_LINE ${_IGOR_ASM_LINES})
+  if(_IGOR_LINE MATCHES "^[0-9a-f]+ <([^>]+)>:$")
+    # NOTE: normalize the symbol names by stripping
+    # the argument list and any leading underscore.
+    set(_IGOR_CUR_FUNCTION "${CMAKE_MATCH_1}")
+    string(REGEX REPLACE "\\(.*$" "" _IGOR_CUR_FUNCTION "${_IGOR_CUR_FUNCTION}")
+    string(REGEX REPLACE "^_" "" _IGOR_CUR_FUNCTION "${_IGOR_CUR_FUNCTION}")
+    list(APPEND _IGOR_FUNCTIONS "${_IGOR_CUR_FUNCTION}")
+    set(_IGOR_COUNT_${_IGOR_CUR_FUNCTION} 0)
+  elseif(_IGOR_CUR_FUNCTION AND _IGOR_LINE MATCHES "^ +[0-9a-f]+:\t")
+    # NOTE: skip alignment padding.
+    if(NOT _IGOR_LINE MATCHES "\t(nop|xchg +%ax,%ax|data16|cs nopw|int3)")
+      math(EXPR _IGOR_COUNT_${_IGOR_CUR_FUNCTION} "${_IGOR_COUNT_${_IGOR_CUR_FUNCTION}} + 1")
+    endif()
+  elseif(_IGOR_LINE STREQUAL "")
+    set(_IGOR_CUR_FUNCTION "")
+  endif()
+endforeach()
+
+# Compare the pairs.
+set(_IGOR_N_PAIRS 0)
+set(_IGOR_FAILED FALSE)
+foreach(_IGOR_FUNCTION ${_IGOR_FUNCTIONS})
+  if(_IGOR_FUNCTION MATCHES "_igor$" OR NOT DEFINED _IGOR_COUNT_${_IGOR_FUNCTION}_igor)
+    continue()
+  endif()
+  set(_IGOR_N_POS ${_IGOR_COUNT_${_IGOR_FUNCTION}})
+  set(_IGOR_N_IGOR ${_IGOR_COUNT_${_IGOR_FUNCTION}_igor})
+  math(EXPR _IGOR_N_PAIRS "${_IGOR_N_PAIRS} + 1")
+  if(_IGOR_N_IGOR GREATER _IGOR_N_POS)
+    message(SEND_ERROR "${_IGOR_FUNCTION}_igor emits ${_IGOR_N_IGOR} instructions, ${_IGOR_FUNCTION} emits ${_IGOR_N_POS}.")
+    set(_IGOR_FAILED TRUE)
+  else()
+    message(STATUS "${_IGOR_FUNCTION}: ${_IGOR_N_POS} instructions, ${_IGOR_FUNCTION}_igor: ${_IGOR_N_IGOR} instructions.")
+  endif()
+endforeach()
+
+if(_IGOR_N_PAIRS EQUAL 0)
+  message(FATAL_ERROR "No function pairs found in '${OBJECT}'.")
+endif()
+if(_IGOR_FAILED)
+  message(FATAL_ERROR "The igor versions of some functions emit more instructions than the positional ones.")
+endif()